@@ -25,12 +25,15 @@
  * https://github.com/surge-synthesizer/shortcircuit-xt
  */
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstring>
 
 #include "scxt-plugin.h"
 #include "version.h"
 #include "app/SCXTEditor.h"
+#include "engine/render_pool.h"
 
 #include "sst/voicemanager/midi1_to_voicemanager.h"
 
@@ -219,6 +222,20 @@ bool SCXTPlugin::notePortsInfo(uint32_t index, bool isInput,
     return true;
 }
 
+static bool isNoteOn(const clap_event_header_t *e)
+{
+    if (e->space_id != CLAP_CORE_EVENT_SPACE_ID)
+        return false;
+    if (e->type == CLAP_EVENT_NOTE_ON)
+        return true;
+    if (e->type == CLAP_EVENT_MIDI)
+    {
+        auto mevt = reinterpret_cast<const clap_event_midi *>(e);
+        return (mevt->data[0] & 0xF0) == 0x90 && mevt->data[2] > 0;
+    }
+    return false;
+}
+
 clap_process_status SCXTPlugin::process(const clap_process *process) noexcept
 {
 #if BUILD_IS_DEBUG
@@ -279,13 +296,23 @@ clap_process_status SCXTPlugin::process(const clap_process *process) noexcept
         nextEvent = ev->get(ev, nextEventIndex);
     }
 
-    for (auto s = 0U; s < process->frames_count; ++s)
+    const auto frames = process->frames_count;
+    const auto nonMainOutputs =
+        std::min((int)process->audio_outputs_count - 1, (int)scxt::numNonMainPluginOutputs);
+    uint32_t s{0};
+    while (s < frames)
     {
         if (blockPos == 0)
         {
-            // Only realy need to run events when we do the block process
-            while (nextEvent && nextEvent->time <= s)
+            // Run the events which are due. Note ons landing later in the block we are
+            // about to render run now too, telling the engine where in the block they
+            // land so they start sample accurately. Anything else waits for its block,
+            // and so does every event behind it, to keep the order.
+            while (nextEvent && (nextEvent->time <= s ||
+                                 (nextEvent->time < s + scxt::blockSize && isNoteOn(nextEvent))))
             {
+                engine->eventSampleOffset =
+                    (int16_t)(nextEvent->time > s ? nextEvent->time - s : 0);
                 handleEvent(nextEvent);
                 nextEventIndex++;
                 if (nextEventIndex < sz)
@@ -293,6 +320,7 @@ clap_process_status SCXTPlugin::process(const clap_process *process) noexcept
                 else
                     nextEvent = nullptr;
             }
+            engine->eventSampleOffset = 0;
 
             engine->processAudio();
             engine->transport.timeInBeats += (double)scxt::blockSize * engine->transport.tempo *
@@ -359,29 +387,36 @@ clap_process_status SCXTPlugin::process(const clap_process *process) noexcept
             }
         }
 
-        // TODO: this can be way more efficient and block wise and stuff
-        out[0][s] = main[0][blockPos];
-        out[1][s] = main[1][blockPos];
-        for (int i = 0; i < scxt::numNonMainPluginOutputs; ++i)
+        /*
+         * Copy as much of the rendered block as the host buffer has room for. The
+         * engine busses hold the rest of the block, so a host buffer which isn't a
+         * multiple of blockSize just picks up from blockPos on the next call.
+         */
+        auto chunk = std::min((uint32_t)(scxt::blockSize - blockPos), frames - s);
+        auto bytes = chunk * sizeof(float);
+        memcpy(out[0] + s, main[0] + blockPos, bytes);
+        memcpy(out[1] + s, main[1] + blockPos, bytes);
+        for (int i = 0; i < nonMainOutputs; ++i)
         {
             float **pout = process->audio_outputs[i + 1].data32;
+            if (!pout)
+                continue;
 
-            if (pout)
+            if (ptch->usesOutputBus(i + 1))
             {
-                pout[0][s] = 0.f;
-                pout[1][s] = 0.f;
+                const auto &src = ptch->busses.pluginNonMainOutputs[i];
+                memcpy(pout[0] + s, src[0] + blockPos, bytes);
+                memcpy(pout[1] + s, src[1] + blockPos, bytes);
             }
-            if (engine->getPatch()->usesOutputBus(i + 1))
+            else
             {
-                if (pout)
-                {
-                    pout[0][s] = engine->getPatch()->busses.pluginNonMainOutputs[i][0][blockPos];
-                    pout[1][s] = engine->getPatch()->busses.pluginNonMainOutputs[i][0][blockPos];
-                }
+                memset(pout[0] + s, 0, bytes);
+                memset(pout[1] + s, 0, bytes);
             }
         }
 
-        blockPos = (blockPos + 1) & (scxt::blockSize - 1);
+        s += chunk;
+        blockPos = (blockPos + chunk) & (scxt::blockSize - 1);
     }
 
     // CLean up past-last-process events since we only sweep when processing in main loop to avoid
@@ -448,9 +483,23 @@ bool SCXTPlugin::activate(double sampleRate, uint32_t minFrameCount,
                           uint32_t maxFrameCount) noexcept
 {
     engine->prepareToPlay(sampleRate);
+    if (engine->renderPool && _host.canUseThreadPool())
+    {
+        engine->renderPool->useHostExecutor(
+            [](void *ctx, uint32_t n) {
+                return static_cast<SCXTPlugin *>(ctx)->_host.threadPoolRequestExec(n);
+            },
+            this);
+    }
     return true;
 }
 
+void SCXTPlugin::threadPoolExec(uint32_t taskIndex) noexcept
+{
+    if (engine->renderPool)
+        engine->renderPool->runHostTask(taskIndex);
+}
+
 /*
  * Parameter support
  */
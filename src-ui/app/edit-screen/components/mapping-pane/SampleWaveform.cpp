@@ -159,14 +159,17 @@ void SampleWaveform::rebuildEnvelopePaths()
     auto startSample = std::clamp((int)std::floor(l * pctStart) - samplePad, 0, (int)l);
     auto numSamples = (int)std::ceil(1.f * l / zoomFactor);
     auto endSample = std::clamp(startSample + numSamples + 2 * samplePad, 0, (int)l);
+    // Disk streamed samples only have their head in memory
+    endSample = std::min(endSample, (int)samp->getResidentLength());
     auto fac = std::max(1.0 * numSamples / r.getWidth(), 1.0);
 
     for (int ch = 0; ch < usedChannels; ++ch)
     {
         std::vector<std::pair<size_t, float>> topLine, bottomLine;
 
-        auto downSampleForUI = [startSample, endSample, fac, &topLine, &bottomLine](auto *data) {
-            using T = std::remove_pointer_t<decltype(data)>;
+        auto downSampleForUI = [startSample, endSample, fac, &topLine,
+                                &bottomLine](auto *data, auto value) {
+            using T = decltype(value(data[0]));
             double c = startSample;
             int ct = 0;
             auto seedmx = std::numeric_limits<T>::min();
@@ -181,7 +184,7 @@ void SampleWaveform::rebuildEnvelopePaths()
             auto mn = seedmn;
 
             T normFactor{1};
-            if constexpr (std::is_same_v<T, int16_t>)
+            if constexpr (std::is_integral_v<T>)
             {
                 normFactor = std::numeric_limits<T>::max();
             }
@@ -200,20 +203,31 @@ void SampleWaveform::rebuildEnvelopePaths()
                     mx = seedmx;
                     mn = seedmn;
                 }
-                mx = std::max(data[s], mx);
-                mn = std::min(data[s], mn);
+                mx = std::max(value(data[s]), mx);
+                mn = std::min(value(data[s]), mn);
             }
         };
 
+        auto asIs = [](auto v) { return v; };
         if (samp->bitDepth == sample::Sample::BD_I16)
         {
             auto d = samp->GetSamplePtrI16(ch);
-            downSampleForUI(d);
+            downSampleForUI(d, asIs);
         }
         else if (samp->bitDepth == sample::Sample::BD_F32)
         {
             auto d = samp->GetSamplePtrF32(ch);
-            downSampleForUI(d);
+            downSampleForUI(d, asIs);
+        }
+        else if (samp->bitDepth == sample::Sample::BD_I24)
+        {
+            auto d = samp->GetSamplePtrI24(ch);
+            downSampleForUI(d, [](const auto &v) { return dsp::normalizedI24(v); });
+        }
+        else if (samp->bitDepth == sample::Sample::BD_I8)
+        {
+            auto d = samp->GetSamplePtrI8(ch);
+            downSampleForUI(d, asIs);
         }
         else
         {
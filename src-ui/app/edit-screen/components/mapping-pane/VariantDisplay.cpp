@@ -513,6 +513,15 @@ void VariantDisplay::rebuild()
     case dsp::InterpolationTypes::ZeroOrderHold:
         srcButton->setLabel("ZOH");
         break;
+    case dsp::InterpolationTypes::Hermite:
+        srcButton->setLabel("HERM");
+        break;
+    case dsp::InterpolationTypes::Polyphase:
+        srcButton->setLabel("POLY");
+        break;
+    case dsp::InterpolationTypes::PolyphaseLong:
+        srcButton->setLabel("POLY64");
+        break;
     }
 
     auto samp = editor->sampleManager.getSample(variantView.variants[selectedVariation].sampleID);
@@ -738,6 +747,9 @@ void VariantDisplay::showSRCMenu()
     add(dsp::InterpolationTypes::Sinc, "Sinc");
     add(dsp::InterpolationTypes::Linear, "Linear");
     add(dsp::InterpolationTypes::ZeroOrderHold, "Zero-order Hold");
+    add(dsp::InterpolationTypes::Hermite, "Hermite (4 point)");
+    add(dsp::InterpolationTypes::Polyphase, "Polyphase (32 tap)");
+    add(dsp::InterpolationTypes::PolyphaseLong, "Polyphase (64 tap)");
 
     p.showMenuAsync(editor->defaultPopupMenuOptions());
 }
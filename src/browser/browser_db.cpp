@@ -35,6 +35,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <deque>
+#include <unordered_set>
 
 #define TRACE_DB 0
 
@@ -239,7 +240,7 @@ struct TxnGuard
 struct WriterWorker
 {
     static constexpr const char *schema_version =
-        "1003"; // I will rebuild if this is not my version
+        "1004"; // I will rebuild if this is not my version
 
     static constexpr const char *setup_sql = R"SQL(
 DROP TABLE IF EXISTS "DebugJunk";
@@ -257,6 +258,15 @@ CREATE TABLE DebugJunk (
 CREATE TABLE IF NOT EXISTS DeviceLocations (
     id integer primary key,
     path varchar(2048)
+);
+-- The content hash cache. modtime is the filesystem clock count, so treat it as opaque.
+-- verified is seconds since the epoch when we last actually hashed the file.
+CREATE TABLE IF NOT EXISTS ContentHashes (
+    path varchar(2048) primary key,
+    size integer,
+    modtime integer,
+    md5 varchar(64),
+    verified integer
 );
     )SQL";
     struct EnQAble
@@ -279,6 +289,31 @@ CREATE TABLE IF NOT EXISTS DeviceLocations (
         void go(WriterWorker &w) override { w.addDeviceLocation(path); }
     };
 
+    struct EnQContentHash : public EnQAble
+    {
+        fs::path path;
+        uint64_t size;
+        int64_t modTime;
+        std::string md5;
+        EnQContentHash(const fs::path &p, uint64_t s, int64_t m, const std::string &h)
+            : path(p), size(s), modTime(m), md5(h)
+        {
+        }
+        void go(WriterWorker &w) override { w.addContentHash(path, size, modTime, md5); }
+    };
+
+    struct EnQVerifyContentHash : public EnQAble
+    {
+        fs::path path;
+        uint64_t size;
+        int64_t modTime;
+        EnQVerifyContentHash(const fs::path &p, uint64_t s, int64_t m)
+            : path(p), size(s), modTime(m)
+        {
+        }
+        void go(WriterWorker &w) override { w.verifyContentHash(path, size, modTime); }
+    };
+
     void openDb()
     {
 #if TRACE_DB
@@ -593,6 +628,68 @@ CREATE TABLE IF NOT EXISTS DeviceLocations (
         }
     }
 
+    static int64_t secondsSinceEpoch()
+    {
+        using namespace std::chrono;
+        return duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    void addContentHash(const fs::path &p, uint64_t size, int64_t modTime,
+                        const std::string &md5)
+    {
+        try
+        {
+            auto there = SQL::Statement(dbh, "INSERT OR REPLACE INTO ContentHashes (\"path\", "
+                                             "\"size\", \"modtime\", \"md5\", \"verified\") "
+                                             "VALUES (?1, ?2, ?3, ?4, ?5)");
+
+            std::string res = p.u8string();
+            there.bind(1, res);
+            there.bindi64(2, (int64_t)size);
+            there.bindi64(3, modTime);
+            there.bind(4, md5);
+            there.bindi64(5, secondsSinceEpoch());
+
+            there.step();
+            there.finalize();
+        }
+        catch (const SQL::Exception &e)
+        {
+            SCLOG(e.what());
+        }
+    }
+
+    void verifyContentHash(const fs::path &p, uint64_t size, int64_t modTime)
+    {
+        std::error_code ec;
+        auto nowSize = fs::file_size(p, ec);
+        auto nowTime = ec ? 0 : (int64_t)fs::last_write_time(p, ec).time_since_epoch().count();
+
+        if (!ec && nowSize == size && nowTime == modTime)
+        {
+            auto md5 = infrastructure::createMD5SumFromFile(p);
+            if (!md5.empty())
+            {
+                addContentHash(p, size, modTime, md5);
+                return;
+            }
+        }
+
+        // The file has moved on from under our entry, so just forget it
+        try
+        {
+            auto there = SQL::Statement(dbh, "DELETE FROM ContentHashes WHERE path = ?1");
+            std::string res = p.u8string();
+            there.bind(1, res);
+            there.step();
+            there.finalize();
+        }
+        catch (const SQL::Exception &e)
+        {
+            SCLOG(e.what());
+        }
+    }
+
     // FIXME for now I am coding this with a locked vector but probably a
     // thread safe queue is the way to go
     std::thread qThread;
@@ -614,6 +711,11 @@ CREATE TABLE IF NOT EXISTS DeviceLocations (
         qCV.notify_all();
     }
 
+    // The read only connection is opened without a sqlite mutex so readers which
+    // can come from multiple threads (like the hash cache) hold this
+    std::mutex roLock;
+    std::unordered_set<std::string> verifyRequested;
+
     sqlite3 *getReadOnlyConn(bool notifyOnError = true)
     {
         if (!rodbh)
@@ -667,6 +769,7 @@ void BrowserDB::addDeviceLocation(const fs::path &p)
 
 std::vector<fs::path> BrowserDB::getDeviceLocations()
 {
+    std::lock_guard<std::mutex> g(writerWorker->roLock);
     auto conn = writerWorker->getReadOnlyConn();
     std::vector<fs::path> res;
 
@@ -689,6 +792,56 @@ std::vector<fs::path> BrowserDB::getDeviceLocations()
     return res;
 }
 
+std::optional<std::string> BrowserDB::getCachedMD5Sum(const fs::path &path, uint64_t size,
+                                                      int64_t modTime)
+{
+    std::lock_guard<std::mutex> g(writerWorker->roLock);
+    auto conn = writerWorker->getReadOnlyConn(false);
+    if (!conn)
+        return std::nullopt;
+
+    std::optional<std::string> res;
+    int64_t verified{0};
+
+    // language=SQL
+    std::string query =
+        "SELECT md5, verified FROM ContentHashes WHERE path = ?1 AND size = ?2 AND modtime = ?3;";
+    try
+    {
+        auto q = SQL::Statement(conn, query);
+        auto ps = path.u8string();
+        q.bind(1, ps);
+        q.bindi64(2, (int64_t)size);
+        q.bindi64(3, modTime);
+        if (q.step())
+        {
+            res = q.col_str(0);
+            verified = q.col_int64(1);
+        }
+        q.finalize();
+    }
+    catch (SQL::Exception &)
+    {
+        // Most likely the writer hasn't set up the table yet, so just hash
+        return std::nullopt;
+    }
+
+    if (res.has_value() &&
+        WriterWorker::secondsSinceEpoch() - verified > hashVerifyIntervalInSeconds &&
+        writerWorker->verifyRequested.insert(path.u8string()).second)
+    {
+        writerWorker->enqueueWorkItem(
+            new WriterWorker::EnQVerifyContentHash(path, size, modTime));
+    }
+    return res;
+}
+
+void BrowserDB::setCachedMD5Sum(const fs::path &path, uint64_t size, int64_t modTime,
+                                const std::string &md5)
+{
+    writerWorker->enqueueWorkItem(new WriterWorker::EnQContentHash(path, size, modTime, md5));
+}
+
 int BrowserDB::numberOfJobsOutstanding() const
 {
     std::lock_guard<std::mutex> guard(writerWorker->qLock);
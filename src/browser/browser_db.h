@@ -29,13 +29,14 @@
 #define SCXT_SRC_BROWSER_BROWSER_DB_H
 
 #include "filesystem/import.h"
+#include "infrastructure/md5support.h"
 #include <memory>
 #include <vector>
 
 namespace scxt::browser
 {
 struct WriterWorker;
-struct BrowserDB
+struct BrowserDB : infrastructure::MD5Cache
 {
     BrowserDB(const fs::path &);
     ~BrowserDB();
@@ -45,6 +46,19 @@ struct BrowserDB
 
     std::vector<fs::path> getDeviceLocations();
 
+    /*
+     * The content hash cache. Lookups are answered from the read only connection and
+     * are safe from any thread; stores go through the writer queue. A cache hit which
+     * hasn't been checked for more than hashVerifyIntervalInSeconds queues a rehash on
+     * the writer thread, so a file modified without changing its size or mtime is
+     * eventually corrected.
+     */
+    std::optional<std::string> getCachedMD5Sum(const fs::path &path, uint64_t size,
+                                               int64_t modTime) override;
+    void setCachedMD5Sum(const fs::path &path, uint64_t size, int64_t modTime,
+                         const std::string &md5) override;
+    static constexpr int64_t hashVerifyIntervalInSeconds{60 * 60 * 24 * 7};
+
     int numberOfJobsOutstanding() const;
     int waitForJobsOutstandingComplete(int maxWaitInMS) const;
 
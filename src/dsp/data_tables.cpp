@@ -34,4 +34,41 @@ SincTable sincTable;
 SurgeSincTable surgeSincTable;
 DbTable dbTable;
 TwoToTheXTable twoToTheXTable;
+
+template <uint32_t tapsT> PolyphaseSincTable<tapsT>::PolyphaseSincTable()
+{
+    static constexpr double cutoff{0.95};
+    static constexpr int taps{(int)tapsT}, half{(int)tapsT / 2};
+    for (int p = 0; p <= (int)polyphasePhases; ++p)
+    {
+        double x = (double)p / polyphasePhases;
+        double row[taps], sum{0};
+        for (int k = 0; k < taps; ++k)
+        {
+            // distance from the interpolation point, and where that lands in the window
+            auto u = k - (half - 1) - x;
+            auto sinc = u == 0 ? 1.0 : std::sin(M_PI * cutoff * u) / (M_PI * cutoff * u);
+            auto wp = 2.0 * M_PI * (u + half) / taps;
+            auto w = 0.35875 - 0.48829 * std::cos(wp) + 0.14128 * std::cos(2 * wp) -
+                     0.01168 * std::cos(3 * wp);
+            row[k] = sinc * w;
+            sum += row[k];
+        }
+        // normalize each phase to unity gain at DC
+        for (int k = 0; k < taps; ++k)
+            table[p * taps + k] = (float)(row[k] / sum);
+    }
+    for (int p = 0; p <= (int)polyphasePhases; ++p)
+    {
+        for (int k = 0; k < taps; ++k)
+        {
+            delta[p * taps + k] = p == (int)polyphasePhases
+                                      ? 0.f
+                                      : table[(p + 1) * taps + k] - table[p * taps + k];
+        }
+    }
+}
+
+PolyphaseSincTable<polyphaseTaps> polyphaseSincTable;
+PolyphaseSincTable<polyphaseLongTaps> polyphaseLongSincTable;
 } // namespace scxt::dsp
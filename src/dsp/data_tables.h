@@ -49,6 +49,21 @@ static_assert(dsp::FIRipol_M == SincTable::FIRipol_M);
 static_assert(dsp::FIRipol_N == SincTable::FIRipol_N);
 static_assert(dsp::FIRipolI16_N == SincTable::FIRipolI16_N);
 
+/*
+ * Blackman-Harris windowed sinc for the Polyphase interpolators. Row p holds the
+ * taps coefficients for a fractional position of p / polyphasePhases, with the
+ * interpolation point between taps taps / 2 - 1 and taps / 2, and delta holds the
+ * step to the next row so we can interpolate between phases.
+ */
+template <uint32_t taps> struct PolyphaseSincTable
+{
+    PolyphaseSincTable();
+    float table alignas(16)[(polyphasePhases + 1) * taps];
+    float delta alignas(16)[(polyphasePhases + 1) * taps];
+};
+extern PolyphaseSincTable<polyphaseTaps> polyphaseSincTable;
+extern PolyphaseSincTable<polyphaseLongTaps> polyphaseLongSincTable;
+
 using DbTable = sst::basic_blocks::tables::DbToLinearProvider;
 extern DbTable dbTable;
 
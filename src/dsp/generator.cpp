@@ -30,6 +30,7 @@
 
 #include "resampling.h"
 #include "data_tables.h"
+#include "sinc_kernels.h"
 #include <fstream>
 #include <iostream>
 #include <algorithm>
@@ -37,6 +38,7 @@
 #include "sst/basic-blocks/mechanics/simd-ops.h"
 #include "utils.h"
 #include <array>
+#include <type_traits>
 #include <cassert>
 
 /*
@@ -57,15 +59,16 @@
  * sample data?
  *
  * So at input, we expect the sample data in GDIO to be pointing at the top of the sample
- * but that sample is sitting in a buffer which is allocated FIROffset (=8) buffers
+ * but that sample is sitting in a buffer which is allocated samplePadding (=32) buffers
  * wider on either side with 0s. That is, we hace valid memory from
- * sample-8 to sample + samplesize + 8 - 1 with zero pads.
+ * sample-32 to sample + samplesize + 32 - 1 with zero pads.
  *
- * 0 0 0 0 0 0 0 0 s s s s .... s s s s 0 0 0 0 0 0 0 0
+ * 0 0 0 ... 0 0 0 s s s s .... s s s s 0 0 0 ... 0 0 0
  *                 ^                  ^
  *               sample            sample + waveSize
  *
- * This allows the processors to have a FIRipol_N{16} wide window in which to interpolate
+ * This allows the processors to have a FIRipol_N{16} wide window in which to interpolate,
+ * and the polyphase ones a window as wide as their kernel
  *
  * So then we get to the last bit of index shuffling. This generator is factored
  * so individual prcoessors have their own process method which generates a samlpe
@@ -118,42 +121,79 @@ template <InterpolationTypes KT, typename T> struct KernelOp
 {
 };
 
-template <InterpolationTypes KT, typename T, int NUM_CHANNELS, bool LOOP_ACTIVE>
+template <InterpolationTypes KT, typename T, int NUM_CHANNELS, bool HAS_FADE>
 struct KernelProcessor;
 
 template <typename T> struct KernelOp<InterpolationTypes::ZeroOrderHold, T>
 {
-    template <int NUM_CHANNELS, bool LOOP_ACTIVE>
+    template <int NUM_CHANNELS, bool HAS_FADE>
     static void
     Process(GeneratorState *__restrict GD,
-            KernelProcessor<InterpolationTypes::ZeroOrderHold, T, NUM_CHANNELS, LOOP_ACTIVE> &ks);
+            KernelProcessor<InterpolationTypes::ZeroOrderHold, T, NUM_CHANNELS, HAS_FADE> &ks);
 };
 
 template <typename T> struct KernelOp<InterpolationTypes::Linear, T>
 {
-    template <int NUM_CHANNELS, bool LOOP_ACTIVE>
+    template <int NUM_CHANNELS, bool HAS_FADE>
     static void
     Process(GeneratorState *__restrict GD,
-            KernelProcessor<InterpolationTypes::Linear, T, NUM_CHANNELS, LOOP_ACTIVE> &ks);
+            KernelProcessor<InterpolationTypes::Linear, T, NUM_CHANNELS, HAS_FADE> &ks);
+};
+
+template <typename T> struct KernelOp<InterpolationTypes::Hermite, T>
+{
+    template <int NUM_CHANNELS, bool HAS_FADE>
+    static void
+    Process(GeneratorState *__restrict GD,
+            KernelProcessor<InterpolationTypes::Hermite, T, NUM_CHANNELS, HAS_FADE> &ks);
+};
+
+// Both lengths of polyphase kernel share one implementation
+template <InterpolationTypes KT, typename T> struct PolyphaseKernelOp
+{
+    template <int NUM_CHANNELS, bool HAS_FADE>
+    static void Process(GeneratorState *__restrict GD,
+                        KernelProcessor<KT, T, NUM_CHANNELS, HAS_FADE> &ks);
+};
+
+template <typename T>
+struct KernelOp<InterpolationTypes::Polyphase, T>
+    : PolyphaseKernelOp<InterpolationTypes::Polyphase, T>
+{
+};
+
+template <typename T>
+struct KernelOp<InterpolationTypes::PolyphaseLong, T>
+    : PolyphaseKernelOp<InterpolationTypes::PolyphaseLong, T>
+{
+};
+
+// The packed formats unpack their window and use the float kernel
+template <typename T> struct KernelOp<InterpolationTypes::Sinc, T>
+{
+    template <int NUM_CHANNELS, bool HAS_FADE>
+    static void
+    Process(GeneratorState *__restrict GD,
+            KernelProcessor<InterpolationTypes::Sinc, T, NUM_CHANNELS, HAS_FADE> &ks);
 };
 
 template <> struct KernelOp<InterpolationTypes::Sinc, float>
 {
-    template <int NUM_CHANNELS, bool LOOP_ACTIVE>
+    template <int NUM_CHANNELS, bool HAS_FADE>
     static void
     Process(GeneratorState *__restrict GD,
-            KernelProcessor<InterpolationTypes::Sinc, float, NUM_CHANNELS, LOOP_ACTIVE> &ks);
+            KernelProcessor<InterpolationTypes::Sinc, float, NUM_CHANNELS, HAS_FADE> &ks);
 };
 
 template <> struct KernelOp<InterpolationTypes::Sinc, int16_t>
 {
-    template <int NUM_CHANNELS, bool LOOP_ACTIVE>
+    template <int NUM_CHANNELS, bool HAS_FADE>
     static void
     Process(GeneratorState *__restrict GD,
-            KernelProcessor<InterpolationTypes::Sinc, int16_t, NUM_CHANNELS, LOOP_ACTIVE> &ks);
+            KernelProcessor<InterpolationTypes::Sinc, int16_t, NUM_CHANNELS, HAS_FADE> &ks);
 };
 
-template <InterpolationTypes KT, typename T, int NUM_CHANNELS, bool LOOP_ACTIVE>
+template <InterpolationTypes KT, typename T, int NUM_CHANNELS, bool HAS_FADE>
 struct KernelProcessor
 {
     int32_t SamplePos, SampleSubPos;
@@ -179,11 +219,15 @@ float NormalizeSampleToF32(float val) { return val; }
 
 float NormalizeSampleToF32(int16_t val) { return val * I16InvScale2; }
 
+float NormalizeSampleToF32(const PackedI24 &val) { return normalizedI24(val); }
+
+float NormalizeSampleToF32(int8_t val) { return normalizedI8(val); }
+
 template <typename T>
-template <int NUM_CHANNELS, bool LOOP_ACTIVE>
+template <int NUM_CHANNELS, bool HAS_FADE>
 void KernelOp<InterpolationTypes::ZeroOrderHold, T>::Process(
     GeneratorState *__restrict GD,
-    KernelProcessor<InterpolationTypes::ZeroOrderHold, T, NUM_CHANNELS, LOOP_ACTIVE> &ks)
+    KernelProcessor<InterpolationTypes::ZeroOrderHold, T, NUM_CHANNELS, HAS_FADE> &ks)
 {
     auto readSampleL{ks.ReadSample[0]};
     auto readFadeSampleL{ks.ReadFadeSample[0]};
@@ -193,7 +237,7 @@ void KernelOp<InterpolationTypes::ZeroOrderHold, T>::Process(
     auto readPos = FIRoffset - 1;
     OutputL[i] = NormalizeSampleToF32(readSampleL[readPos]);
 
-    if constexpr (LOOP_ACTIVE)
+    if constexpr (HAS_FADE)
     {
         if (ks.fadeActive)
         {
@@ -215,7 +259,7 @@ void KernelOp<InterpolationTypes::ZeroOrderHold, T>::Process(
 
         OutputR[i] = NormalizeSampleToF32(readSampleR[readPos]);
 
-        if constexpr (LOOP_ACTIVE)
+        if constexpr (HAS_FADE)
         {
             if (ks.fadeActive)
             {
@@ -232,10 +276,10 @@ void KernelOp<InterpolationTypes::ZeroOrderHold, T>::Process(
 }
 
 template <typename T>
-template <int NUM_CHANNELS, bool LOOP_ACTIVE>
+template <int NUM_CHANNELS, bool HAS_FADE>
 void KernelOp<InterpolationTypes::Linear, T>::Process(
     GeneratorState *__restrict GD,
-    KernelProcessor<InterpolationTypes::Linear, T, NUM_CHANNELS, LOOP_ACTIVE> &ks)
+    KernelProcessor<InterpolationTypes::Linear, T, NUM_CHANNELS, HAS_FADE> &ks)
 {
     auto readSampleL{ks.ReadSample[0]};
     auto readFadeSampleL{ks.ReadFadeSample[0]};
@@ -253,7 +297,7 @@ void KernelOp<InterpolationTypes::Linear, T>::Process(
 
     OutputL[i] = (y0 * (1 - f_subPos) + y1 * (f_subPos));
 
-    if constexpr (LOOP_ACTIVE)
+    if constexpr (HAS_FADE)
     {
         if (ks.fadeActive)
         {
@@ -280,7 +324,7 @@ void KernelOp<InterpolationTypes::Linear, T>::Process(
 
         OutputR[i] = (y0 * (1 - f_subPos) + y1 * (f_subPos));
 
-        if constexpr (LOOP_ACTIVE)
+        if constexpr (HAS_FADE)
         {
             if (ks.fadeActive)
             {
@@ -299,10 +343,157 @@ void KernelOp<InterpolationTypes::Linear, T>::Process(
     }
 }
 
-template <int NUM_CHANNELS, bool LOOP_ACTIVE>
+// Catmull-Rom weights for taps at -1, 0, 1, 2 around a fractional position f
+inline void hermiteWeights(float f, float &w0, float &w1, float &w2, float &w3)
+{
+    w0 = ((-0.5f * f + 1.f) * f - 0.5f) * f;
+    w1 = (1.5f * f - 2.5f) * f * f + 1.f;
+    w2 = ((-1.5f * f + 2.f) * f + 0.5f) * f;
+    w3 = (0.5f * f - 0.5f) * f * f;
+}
+
+template <typename T>
+template <int NUM_CHANNELS, bool HAS_FADE>
+void KernelOp<InterpolationTypes::Hermite, T>::Process(
+    GeneratorState *__restrict GD,
+    KernelProcessor<InterpolationTypes::Hermite, T, NUM_CHANNELS, HAS_FADE> &ks)
+{
+    auto i{ks.i};
+    auto f_subPos = (float)(ks.SampleSubPos);
+    f_subPos /= (1 << 24);
+    float w0, w1, w2, w3;
+    hermiteWeights(f_subPos, w0, w1, w2, w3);
+
+    auto readPos = FIRoffset - 1;
+    auto interp = [&](const T *r) {
+        return w0 * NormalizeSampleToF32(r[readPos - 1]) + w1 * NormalizeSampleToF32(r[readPos]) +
+               w2 * NormalizeSampleToF32(r[readPos + 1]) +
+               w3 * NormalizeSampleToF32(r[readPos + 2]);
+    };
+
+    float fadeGain{0.f}, aOut{1.f};
+    if constexpr (HAS_FADE)
+    {
+        if (ks.fadeActive)
+        {
+            fadeGain =
+                getFadeGain(ks.SamplePos, GD->loopUpperBound - ks.loopFade, GD->loopUpperBound);
+            aOut = getFadeGainToAmp(1.f - fadeGain);
+            fadeGain = getFadeGainToAmp(fadeGain);
+        }
+    }
+
+    for (int c = 0; c < NUM_CHANNELS; ++c)
+    {
+        ks.Output[c][i] = interp(ks.ReadSample[c]);
+        if constexpr (HAS_FADE)
+        {
+            if (ks.fadeActive)
+                ks.Output[c][i] = ks.Output[c][i] * aOut + interp(ks.ReadFadeSample[c]) * fadeGain;
+        }
+    }
+}
+
+inline __m128 loadFourAsF32(const float *d) { return _mm_loadu_ps(d); }
+
+inline __m128 loadFourAsF32(const int16_t *d)
+{
+    auto i32 = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)d));
+    return _mm_mul_ps(_mm_cvtepi32_ps(i32), _mm_set1_ps(I16InvScale2));
+}
+
+template <InterpolationTypes KT> constexpr int polyphaseTapsFor()
+{
+    return KT == InterpolationTypes::PolyphaseLong ? polyphaseLongTaps : polyphaseTaps;
+}
+
+template <int taps> const PolyphaseSincTable<taps> &polyphaseTableFor()
+{
+    if constexpr (taps == (int)polyphaseLongTaps)
+        return polyphaseLongSincTable;
+    else
+        return polyphaseSincTable;
+}
+
+// The kernel for a sub sample position, interpolated between the table's phases
+template <int taps> inline void polyphaseCoefficients(int32_t sub, __m128 *coef)
+{
+    const auto &pt = polyphaseTableFor<taps>();
+    auto phase = (sub >> 16) * taps;
+    auto frac = _mm_set1_ps((float)(sub & 0xffff) * (1.f / 65536.f));
+    for (int q = 0; q < taps / 4; ++q)
+        coef[q] = _mm_add_ps(_mm_load_ps(pt.table + phase + q * 4),
+                             _mm_mul_ps(_mm_load_ps(pt.delta + phase + q * 4), frac));
+}
+
+// r points taps / 2 before the sample position
+template <int taps, typename T> inline float polyphaseApply(const T *r, const __m128 *coef)
+{
+    auto acc = _mm_mul_ps(coef[0], loadFourAsF32(r));
+    for (int q = 1; q < taps / 4; ++q)
+        acc = _mm_add_ps(acc, _mm_mul_ps(coef[q], loadFourAsF32(r + q * 4)));
+    acc = _mm_hadd_ps(acc, acc);
+    acc = _mm_hadd_ps(acc, acc);
+    return _mm_cvtss_f32(acc);
+}
+
+/*
+ * The generator hands the polyphase kernels a window starting taps / 2 before the
+ * sample position, and pads the data and its loop end buffers to match, so the per
+ * sample path runs the same kernel as the runs do.
+ */
+template <InterpolationTypes KT, typename T>
+template <int NUM_CHANNELS, bool HAS_FADE>
+void PolyphaseKernelOp<KT, T>::Process(GeneratorState *__restrict GD,
+                                       KernelProcessor<KT, T, NUM_CHANNELS, HAS_FADE> &ks)
+{
+    static constexpr int taps{polyphaseTapsFor<KT>()};
+    __m128 coef[taps / 4];
+    polyphaseCoefficients<taps>(ks.SampleSubPos, coef);
+
+    auto interp = [&coef](const T *r) {
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, int16_t>)
+        {
+            return polyphaseApply<taps>(r, coef);
+        }
+        else
+        {
+            // The packed formats unpack their window, as their runs do
+            float window alignas(16)[taps];
+            for (int k = 0; k < taps; ++k)
+                window[k] = NormalizeSampleToF32(r[k]);
+            return polyphaseApply<taps>(window, coef);
+        }
+    };
+
+    float fadeGain{0.f}, aOut{1.f};
+    if constexpr (HAS_FADE)
+    {
+        if (ks.fadeActive)
+        {
+            fadeGain =
+                getFadeGain(ks.SamplePos, GD->loopUpperBound - ks.loopFade, GD->loopUpperBound);
+            aOut = getFadeGainToAmp(1.f - fadeGain);
+            fadeGain = getFadeGainToAmp(fadeGain);
+        }
+    }
+
+    for (int c = 0; c < NUM_CHANNELS; ++c)
+    {
+        ks.Output[c][ks.i] = interp(ks.ReadSample[c]);
+        if constexpr (HAS_FADE)
+        {
+            if (ks.fadeActive)
+                ks.Output[c][ks.i] =
+                    ks.Output[c][ks.i] * aOut + interp(ks.ReadFadeSample[c]) * fadeGain;
+        }
+    }
+}
+
+template <int NUM_CHANNELS, bool HAS_FADE>
 void KernelOp<InterpolationTypes::Sinc, float>::Process(
     GeneratorState *__restrict GD,
-    KernelProcessor<InterpolationTypes::Sinc, float, NUM_CHANNELS, LOOP_ACTIVE> &ks)
+    KernelProcessor<InterpolationTypes::Sinc, float, NUM_CHANNELS, HAS_FADE> &ks)
 {
     auto readSampleL{ks.ReadSample[0]};
     auto readFadeSampleL{ks.ReadFadeSample[0]};
@@ -349,7 +540,7 @@ void KernelOp<InterpolationTypes::Sinc, float>::Process(
 
     _mm_store_ss(&OutputL[i], sL4);
 
-    if constexpr (LOOP_ACTIVE)
+    if constexpr (HAS_FADE)
     {
         if (ks.fadeActive)
         {
@@ -388,7 +579,7 @@ void KernelOp<InterpolationTypes::Sinc, float>::Process(
 
         _mm_store_ss(&OutputR[i], sR4);
 
-        if constexpr (LOOP_ACTIVE)
+        if constexpr (HAS_FADE)
         {
             if (ks.fadeActive)
             {
@@ -413,10 +604,10 @@ void KernelOp<InterpolationTypes::Sinc, float>::Process(
     }
 }
 
-template <int NUM_CHANNELS, bool LOOP_ACTIVE>
+template <int NUM_CHANNELS, bool HAS_FADE>
 void KernelOp<InterpolationTypes::Sinc, int16_t>::Process(
     GeneratorState *__restrict GD,
-    KernelProcessor<InterpolationTypes::Sinc, int16_t, NUM_CHANNELS, LOOP_ACTIVE> &ks)
+    KernelProcessor<InterpolationTypes::Sinc, int16_t, NUM_CHANNELS, HAS_FADE> &ks)
 {
     auto readSampleL{ks.ReadSample[0]};
     auto readFadeSampleL{ks.ReadFadeSample[0]};
@@ -471,7 +662,7 @@ void KernelOp<InterpolationTypes::Sinc, int16_t>::Process(
     if constexpr (stereo)
         _mm_store_ss(&OutputR[i], fR);
 
-    if constexpr (LOOP_ACTIVE)
+    if constexpr (HAS_FADE)
     {
         if (ks.fadeActive)
         {
@@ -523,13 +714,363 @@ void KernelOp<InterpolationTypes::Sinc, int16_t>::Process(
     }
 }
 
-template <int compoundConfig>
+template <typename T>
+template <int NUM_CHANNELS, bool HAS_FADE>
+void KernelOp<InterpolationTypes::Sinc, T>::Process(
+    GeneratorState *__restrict GD,
+    KernelProcessor<InterpolationTypes::Sinc, T, NUM_CHANNELS, HAS_FADE> &ks)
+{
+    float window alignas(16)[NUM_CHANNELS][FIRipol_N];
+    float fadeWindow alignas(16)[NUM_CHANNELS][FIRipol_N];
+
+    KernelProcessor<InterpolationTypes::Sinc, float, NUM_CHANNELS, HAS_FADE> fk;
+    fk.SamplePos = ks.SamplePos;
+    fk.SampleSubPos = ks.SampleSubPos;
+    fk.m0 = ks.m0;
+    fk.i = ks.i;
+    fk.fadeActive = ks.fadeActive;
+    fk.loopFade = ks.loopFade;
+    fk.IO = ks.IO;
+    for (int c = 0; c < NUM_CHANNELS; ++c)
+    {
+        for (int k = 0; k < (int)FIRipol_N; ++k)
+            window[c][k] = NormalizeSampleToF32(ks.ReadSample[c][k]);
+        fk.ReadSample[c] = window[c];
+        fk.ReadFadeSample[c] = nullptr;
+        if constexpr (HAS_FADE)
+        {
+            if (ks.fadeActive)
+            {
+                for (int k = 0; k < (int)FIRipol_N; ++k)
+                    fadeWindow[c][k] = NormalizeSampleToF32(ks.ReadFadeSample[c][k]);
+                fk.ReadFadeSample[c] = fadeWindow[c];
+            }
+        }
+        fk.Output[c] = ks.Output[c];
+    }
+    fk.ProcessKernel(GD);
+}
+
+/*
+ * Runs. Given a start position and a fixed step these render n outputs without any
+ * loop, bound or fade handling. The read positions for the whole run are worked out
+ * in one pass up front so the interpolation loop is just loads and arithmetic.
+ */
+static constexpr int maxRunLength{blockSize << 2};
+
+inline void runPositions(int32_t pos, int32_t sub, int32_t step, int n, int32_t *positions,
+                         float *fractions)
+{
+    for (int j = 0; j < n; ++j)
+    {
+        auto total = (int64_t)sub + (int64_t)step * j;
+        positions[j] = pos + (int32_t)(total >> 24);
+        fractions[j] = (float)(total & 0xffffff) / (1 << 24);
+    }
+}
+
+template <typename T, int NCH>
+void zeroOrderHoldRun(const T *const *data, int32_t pos, int32_t sub, int32_t step,
+                      float *const *out, int n)
+{
+    int32_t positions alignas(16)[maxRunLength];
+    float fractions alignas(16)[maxRunLength];
+    runPositions(pos, sub, step, n, positions, fractions);
+    for (int c = 0; c < NCH; ++c)
+    {
+        // The per sample kernel reads FIRoffset - 1 into the window, so position - 1
+        auto d = data[c] - 1;
+        for (int j = 0; j < n; ++j)
+            out[c][j] = NormalizeSampleToF32(d[positions[j]]);
+    }
+}
+
+template <typename T, int NCH>
+void linearRun(const T *const *data, int32_t pos, int32_t sub, int32_t step, float *const *out,
+               int n)
+{
+    int32_t positions alignas(16)[maxRunLength];
+    float fractions alignas(16)[maxRunLength];
+    runPositions(pos, sub, step, n, positions, fractions);
+    for (int c = 0; c < NCH; ++c)
+    {
+        auto d = data[c] - 1;
+        for (int j = 0; j < n; ++j)
+        {
+            auto y0 = NormalizeSampleToF32(d[positions[j]]);
+            auto y1 = NormalizeSampleToF32(d[positions[j] + 1]);
+            out[c][j] = y0 * (1 - fractions[j]) + y1 * fractions[j];
+        }
+    }
+}
+
+template <typename T, int NCH>
+void hermiteRun(const T *const *data, int32_t pos, int32_t sub, int32_t step, float *const *out,
+                int n)
+{
+    int32_t positions alignas(16)[maxRunLength];
+    float fractions alignas(16)[maxRunLength];
+    runPositions(pos, sub, step, n, positions, fractions);
+
+    for (int c = 0; c < NCH; ++c)
+    {
+        auto d = data[c] - 2;
+        int j{0};
+        // Four outputs at a time: load each output's four taps and transpose them into
+        // one register per tap so the weights apply across outputs
+        for (; j + 4 <= n; j += 4)
+        {
+            auto f = _mm_load_ps(fractions + j);
+            auto t0 = loadFourAsF32(d + positions[j]);
+            auto t1 = loadFourAsF32(d + positions[j + 1]);
+            auto t2 = loadFourAsF32(d + positions[j + 2]);
+            auto t3 = loadFourAsF32(d + positions[j + 3]);
+            _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+
+            auto half = _mm_set1_ps(0.5f);
+            auto one = _mm_set1_ps(1.f);
+            auto w0 = _mm_mul_ps(
+                _mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.5f), f), one), f),
+                           half),
+                f);
+            auto w1 = _mm_add_ps(
+                _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.5f), f),
+                                                 _mm_set1_ps(2.5f)),
+                                      f),
+                           f),
+                one);
+            auto w2 = _mm_mul_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.5f), f),
+                                                 _mm_set1_ps(2.f)),
+                                      f),
+                           half),
+                f);
+            auto w3 = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(half, f), half), f), f);
+
+            auto r = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, t0), _mm_mul_ps(w1, t1)),
+                                           _mm_mul_ps(w2, t2)),
+                                _mm_mul_ps(w3, t3));
+            _mm_storeu_ps(out[c] + j, r);
+        }
+        for (; j < n; ++j)
+        {
+            float w0, w1, w2, w3;
+            hermiteWeights(fractions[j], w0, w1, w2, w3);
+            auto p = d + positions[j];
+            out[c][j] = w0 * NormalizeSampleToF32(p[0]) + w1 * NormalizeSampleToF32(p[1]) +
+                        w2 * NormalizeSampleToF32(p[2]) + w3 * NormalizeSampleToF32(p[3]);
+        }
+    }
+}
+
+template <typename T, int NCH, int taps>
+void polyphaseRun(const T *const *data, int32_t pos, int32_t sub, int32_t step,
+                  float *const *out, int n)
+{
+    static constexpr int half{taps / 2};
+    for (int j = 0; j < n; ++j)
+    {
+        __m128 coef[taps / 4];
+        polyphaseCoefficients<taps>(sub, coef);
+        for (int c = 0; c < NCH; ++c)
+            out[c][j] = polyphaseApply<taps>(data[c] + pos - half, coef);
+        sub += step;
+        auto incr = sub >> 24;
+        pos += incr;
+        sub -= incr << 24;
+    }
+}
+
+// Convert count samples to normalized float
+inline void unpackToF32(const PackedI24 *src, int count, float *dst)
+{
+    int j{0};
+    // Four samples are twelve bytes but we load sixteen, so stop while that stays inside
+    for (; j + 6 <= count; j += 4)
+    {
+        auto bytes = _mm_loadu_si128((const __m128i *)(src + j));
+        // each sample's three bytes into the top of a 32 bit lane, then sign extend down
+        auto lanes = _mm_shuffle_epi8(
+            bytes, _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11));
+        auto i32 = _mm_srai_epi32(lanes, 8);
+        _mm_storeu_ps(dst + j,
+                      _mm_mul_ps(_mm_cvtepi32_ps(i32), _mm_set1_ps(1.f / 8388608.f)));
+    }
+    for (; j < count; ++j)
+        dst[j] = normalizedI24(src[j]);
+}
+
+inline void unpackToF32(const int8_t *src, int count, float *dst)
+{
+    int j{0};
+    for (; j + 4 <= count; j += 4)
+    {
+        int32_t four;
+        memcpy(&four, src + j, sizeof(four));
+        auto i32 = _mm_cvtepi8_epi32(_mm_cvtsi32_si128(four));
+        _mm_storeu_ps(dst + j, _mm_mul_ps(_mm_cvtepi32_ps(i32), _mm_set1_ps(1.f / 128.f)));
+    }
+    for (; j < count; ++j)
+        dst[j] = normalizedI8(src[j]);
+}
+
+// How far either side of a position each interpolator reads in a run
+template <InterpolationTypes IT> constexpr int32_t runReach()
+{
+    if constexpr (IT == InterpolationTypes::Sinc)
+        return FIRoffset;
+    else if constexpr (IT == InterpolationTypes::Polyphase ||
+                       IT == InterpolationTypes::PolyphaseLong)
+        return polyphaseTapsFor<IT>() / 2;
+    else if constexpr (IT == InterpolationTypes::Hermite)
+        return 2;
+    else
+        return 1;
+}
+
+/*
+ * Where the per sample window for each interpolator starts, before the sample
+ * position. It is twice this wide, which is also the size of the loop end buffer.
+ */
+template <InterpolationTypes IT> constexpr int32_t windowOffset()
+{
+    if constexpr (IT == InterpolationTypes::Polyphase || IT == InterpolationTypes::PolyphaseLong)
+        return polyphaseTapsFor<IT>() / 2;
+    else
+        return FIRoffset;
+}
+static_assert(windowOffset<InterpolationTypes::PolyphaseLong>() <= (int32_t)samplePadding);
+
+template <typename T, int NCH, InterpolationTypes IT>
+void generatorRun(const T *const *data, int32_t pos, int32_t sub, int32_t step, float *const *out,
+                  int n);
+
+/*
+ * The packed formats render runs by unpacking the stretch of sample a run reads into
+ * float and handing that to the float kernels, a piece at a time so the stretch fits
+ * on the stack.
+ */
+template <typename T, int NCH, InterpolationTypes IT>
+void packedRun(const T *const *data, int32_t pos, int32_t sub, int32_t step, float **out, int n)
+{
+    static constexpr int32_t span{1024}, reach{runReach<IT>()};
+    float unpacked alignas(16)[NCH][span];
+
+    auto maxSteps = (((int64_t)(span - 2 * reach - 1)) << 24) / std::max(1, std::abs(step));
+    auto piece = (int)std::clamp(maxSteps, (int64_t)1, (int64_t)n);
+    while (n > 0)
+    {
+        auto m = std::min(n, piece);
+        auto endPos = pos + (int32_t)(((int64_t)sub + (int64_t)step * (m - 1)) >> 24);
+        auto lo = std::min(pos, endPos) - reach;
+        auto hi = std::max(pos, endPos) + reach - 1;
+
+        const float *fdata[2]{nullptr, nullptr};
+        float *fout[2]{nullptr, nullptr};
+        for (int c = 0; c < NCH; ++c)
+        {
+            unpackToF32(data[c] + lo, hi - lo + 1, unpacked[c]);
+            fdata[c] = unpacked[c];
+            fout[c] = out[c];
+        }
+        generatorRun<float, NCH, IT>(fdata, pos - lo, sub, step, fout, m);
+
+        advanceSamplePosition(pos, sub, step, m);
+        for (int c = 0; c < NCH; ++c)
+            out[c] += m;
+        n -= m;
+    }
+}
+
+template <typename T, int NCH, InterpolationTypes IT>
+void generatorRun(const T *const *data, int32_t pos, int32_t sub, int32_t step, float *const *out,
+                  int n)
+{
+    if constexpr (std::is_same_v<T, PackedI24> || std::is_same_v<T, int8_t>)
+    {
+        float *pieceOut[2]{out[0], NCH > 1 ? out[1] : nullptr};
+        packedRun<T, NCH, IT>(data, pos, sub, step, pieceOut, n);
+    }
+    else if constexpr (IT == InterpolationTypes::Sinc)
+    {
+        if constexpr (std::is_same_v<T, float>)
+            sincKernels.runF32(data, NCH, pos, sub, step, out, n);
+        else
+            sincKernels.runI16(data, NCH, pos, sub, step, out, n);
+    }
+    else if constexpr (IT == InterpolationTypes::Linear)
+    {
+        linearRun<T, NCH>(data, pos, sub, step, out, n);
+    }
+    else if constexpr (IT == InterpolationTypes::Hermite)
+    {
+        hermiteRun<T, NCH>(data, pos, sub, step, out, n);
+    }
+    else if constexpr (IT == InterpolationTypes::Polyphase ||
+                       IT == InterpolationTypes::PolyphaseLong)
+    {
+        polyphaseRun<T, NCH, polyphaseTapsFor<IT>()>(data, pos, sub, step, out, n);
+    }
+    else
+    {
+        zeroOrderHoldRun<T, NCH>(data, pos, sub, step, out, n);
+    }
+}
+
+/*
+ * How many outputs from here we can render as a run. That is how far we can step
+ * before the per sample path would wrap a loop, turn around, clamp at a bound, or
+ * need the hand built window at the loop end. Fades are left to the per sample path.
+ */
+template <bool loopActive, bool loopForward, bool loopWhileGated, InterpolationTypes IT>
+int runLength(GeneratorState *__restrict GD, int32_t pos, int32_t sub, int32_t step,
+              bool fadeActive, int waveSize, int n)
+{
+    static constexpr int resampFIRSize{2 * windowOffset<IT>()};
+    int32_t lower{GD->playbackLowerBound}, upper{GD->playbackUpperBound};
+    if constexpr (loopActive)
+    {
+        if (fadeActive)
+            return 0;
+
+        bool looping = !loopWhileGated || GD->gated ||
+                       (!loopForward && GD->direction != GD->directionAtOutset);
+        if (looping)
+        {
+            // Only the edge we are heading for matters; the other one is a no-op
+            auto turn = loopForward ? 0 : 1;
+            if (step > 0)
+            {
+                lower = 0;
+                upper = GD->loopUpperBound - turn;
+            }
+            else
+            {
+                lower = GD->loopLowerBound + turn;
+                upper = waveSize;
+            }
+        }
+        upper = std::min(upper, waveSize - resampFIRSize - 1);
+    }
+    return boundedRunLength(pos, sub, step, lower, upper, std::min(n, maxRunLength));
+}
+
+template <int compoundConfig, bool withRuns = true>
 void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO);
 
-int toLoopValue(bool active, bool forward, bool whileGated, bool isFloat, bool isStereo)
+/*
+ * The compound config. Everything which is fixed for the life of a voice goes in here
+ * so each voice gets a generator with no runtime choice of interpolation and, if the
+ * loop has no fade, no fade handling at all. Playback direction isn't in here since a
+ * ping pong loop changes it as it plays.
+ */
+static constexpr int loopValueBits{10};
+
+int toLoopValue(bool active, bool forward, bool whileGated, SampleDataFormat format,
+                bool isStereo, InterpolationTypes interpolation, bool hasFade)
 {
-    return ((isStereo * 1) << 4) + ((isFloat * 1) << 3) + ((active * 1) << 2) +
-           ((forward * 1) << 1) + (whileGated * 1);
+    return ((hasFade * 1) << 9) + (((int)interpolation & 7) << 6) + (((int)format & 3) << 4) +
+           ((isStereo * 1) << 3) + ((active * 1) << 2) + ((forward * 1) << 1) + (whileGated * 1);
 }
 
 constexpr std::array<bool, 5> fromLoopValue(int lv)
@@ -537,40 +1078,96 @@ constexpr std::array<bool, 5> fromLoopValue(int lv)
     bool whileGated = (lv & (1 << 0));
     bool forward = (lv & (1 << 1));
     bool active = (lv & (1 << 2));
-    bool isfl = (lv & (1 << 3));
-    bool stereo = (lv & (1 << 4));
-    return {active, forward, whileGated, isfl, stereo};
+    bool stereo = (lv & (1 << 3));
+    bool fade = (lv & (1 << 9));
+    return {active, forward, whileGated, stereo, fade};
+}
+
+constexpr SampleDataFormat formatFromLoopValue(int lv) { return (SampleDataFormat)((lv >> 4) & 3); }
+
+constexpr InterpolationTypes interpolationFromLoopValue(int lv)
+{
+    auto it = (lv >> 6) & 7;
+    return it > InterpolationTypes::PolyphaseLong ? InterpolationTypes::Sinc
+                                                  : (InterpolationTypes)it;
+}
+
+// Collapse configs which generate the same code so we only instantiate each once
+constexpr int canonicalLoopValue(int lv)
+{
+    auto res = lv & ~(7 << 6);
+    res |= ((int)interpolationFromLoopValue(lv)) << 6;
+    if (!(lv & (1 << 2)))
+        res &= ~((1 << 0) | (1 << 1) | (1 << 9));
+    return res;
 }
 
+template <SampleDataFormat F> struct SampleDataType
+{
+    using type = int16_t;
+};
+template <> struct SampleDataType<SDF_F32>
+{
+    using type = float;
+};
+template <> struct SampleDataType<SDF_I24>
+{
+    using type = PackedI24;
+};
+template <> struct SampleDataType<SDF_I8>
+{
+    using type = int8_t;
+};
+
 namespace detail
 {
 using genOp_t = GeneratorFPtr (*)();
-template <size_t I> GeneratorFPtr implGeneratorGetImpl() { return GeneratorSample<I>; }
+template <size_t I, bool withRuns> GeneratorFPtr implGeneratorGetImpl()
+{
+    return GeneratorSample<canonicalLoopValue(I), withRuns>;
+}
 
-template <size_t... Is> auto generatorGet(size_t ft, std::index_sequence<Is...>)
+template <bool withRuns, size_t... Is> auto generatorGet(size_t ft, std::index_sequence<Is...>)
 {
-    constexpr genOp_t fnc[] = {detail::implGeneratorGetImpl<Is>...};
+    constexpr genOp_t fnc[] = {detail::implGeneratorGetImpl<Is, withRuns>...};
     return fnc[ft]();
 }
 } // namespace detail
 
-GeneratorFPtr GetFPtrGeneratorSample(bool Stereo, bool Float, bool loopActive, bool loopForward,
-                                     bool loopWhileGated)
+GeneratorFPtr GetFPtrGeneratorSample(bool Stereo, SampleDataFormat format, bool loopActive,
+                                     bool loopForward, bool loopWhileGated,
+                                     InterpolationTypes interpolation, bool loopHasFade)
 {
-    auto loopValue = toLoopValue(loopActive, loopForward, loopWhileGated, Float, Stereo);
-    assert(loopValue >= 0 && loopValue < (1 << 5));
-    return detail::generatorGet(loopValue, std::make_index_sequence<(1 << 5)>());
+    auto loopValue = toLoopValue(loopActive, loopForward, loopWhileGated, format, Stereo,
+                                 interpolation, loopHasFade);
+    assert(loopValue >= 0 && loopValue < (1 << loopValueBits));
+    return detail::generatorGet<true>(loopValue,
+                                      std::make_index_sequence<(1 << loopValueBits)>());
 }
 
-template <int loopValue>
+GeneratorFPtr GetFPtrGeneratorSamplePerSample(bool Stereo, SampleDataFormat format,
+                                              bool loopActive, bool loopForward,
+                                              bool loopWhileGated,
+                                              InterpolationTypes interpolation, bool loopHasFade)
+{
+    auto loopValue = toLoopValue(loopActive, loopForward, loopWhileGated, format, Stereo,
+                                 interpolation, loopHasFade);
+    assert(loopValue >= 0 && loopValue < (1 << loopValueBits));
+    return detail::generatorGet<false>(loopValue,
+                                       std::make_index_sequence<(1 << loopValueBits)>());
+}
+
+template <int loopValue, bool withRuns>
 void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
 {
     static constexpr auto mode = fromLoopValue(loopValue);
     static constexpr auto loopActive = std::get<0>(mode);
     static constexpr auto loopForward = std::get<1>(mode);
     static constexpr auto loopWhileGated = std::get<2>(mode);
-    static constexpr auto fp = std::get<3>(mode);
-    static constexpr auto stereo = std::get<4>(mode);
+    static constexpr auto stereo = std::get<3>(mode);
+    static constexpr auto hasFade = loopActive && std::get<4>(mode);
+    static constexpr auto interpolation = interpolationFromLoopValue(loopValue);
+    using T = typename SampleDataType<formatFromLoopValue(loopValue)>::type;
 
     int SamplePos = GD->samplePos;
     int SampleSubPos = GD->sampleSubPos;
@@ -581,196 +1178,126 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
     int RatioSign = Ratio < 0 ? -1 : 1;
     Ratio = std::abs(Ratio);
     int Direction = GD->direction * RatioSign;
-    int16_t *__restrict SampleDataL;
-    int16_t *__restrict SampleDataR;
-    float *__restrict SampleDataFL;
-    float *__restrict SampleDataFR;
+    T *__restrict SampleDataL;
+    T *__restrict SampleDataR{nullptr};
     float *__restrict OutputL;
-    float *__restrict OutputR;
+    float *__restrict OutputR{nullptr};
 
-    int loopFade = std::min(GD->loopFade, GD->loopLowerBound - GD->playbackLowerBound);
-    loopFade = std::min(loopFade, GD->loopUpperBound - GD->loopLowerBound);
+    int loopFade{0};
+    if constexpr (hasFade)
+    {
+        loopFade = std::min(GD->loopFade, GD->loopLowerBound - GD->playbackLowerBound);
+        loopFade = std::min(loopFade, GD->loopUpperBound - GD->loopLowerBound);
+    }
 
-    bool fadeActive =
-        SamplePos > (GD->loopUpperBound - loopFade) && SamplePos <= GD->loopUpperBound;
+    bool fadeActive = hasFade && SamplePos > (GD->loopUpperBound - loopFade) &&
+                      SamplePos <= GD->loopUpperBound;
 
     GD->positionWithinLoop = 0.f;
     GD->isInLoop = false;
 
-    if (fp)
-        SampleDataFL = (float *)IO->sampleDataL;
-    else
-        SampleDataL = (short *)IO->sampleDataL;
+    SampleDataL = (T *)IO->sampleDataL;
     OutputL = IO->outputL;
     if (stereo)
     {
-        if (fp)
-            SampleDataFR = (float *)IO->sampleDataR;
-        SampleDataR = (short *)IO->sampleDataR;
+        SampleDataR = (T *)IO->sampleDataR;
         OutputR = IO->outputR;
     }
 
-    static constexpr int resampFIRSize{16};
-    int16_t *__restrict readSampleL = nullptr;
-    int16_t *__restrict readSampleR = nullptr;
-    int16_t *__restrict readFadeSampleL = nullptr;
-    int16_t *__restrict readFadeSampleR = nullptr;
-    int16_t loopEndBufferL[resampFIRSize], loopEndBufferR[resampFIRSize];
-    float *__restrict readSampleLF32 = nullptr;
-    float *__restrict readSampleRF32 = nullptr;
-    float *__restrict readFadeSampleLF32 = nullptr;
-    float *__restrict readFadeSampleRF32 = nullptr;
-    float loopEndBufferLF32[resampFIRSize], loopEndBufferRF32[resampFIRSize];
-
-    if (fp)
-    {
-        // See comment above - the generator wants an FIRoffset centered data set
-        readSampleLF32 = SampleDataFL + SamplePos - FIRoffset;
-        if (stereo)
-            readSampleRF32 = SampleDataFR + SamplePos - FIRoffset;
+    static constexpr int32_t readOffset{windowOffset<interpolation>()};
+    static constexpr int resampFIRSize{2 * readOffset};
+    T *__restrict readSampleL = nullptr;
+    T *__restrict readSampleR = nullptr;
+    T *__restrict readFadeSampleL = nullptr;
+    T *__restrict readFadeSampleR = nullptr;
+    T loopEndBufferL[resampFIRSize], loopEndBufferR[resampFIRSize];
 
-        if constexpr (loopActive)
-        {
-            if (fadeActive)
-            {
-                auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
-                readFadeSampleLF32 = SampleDataFL + fadeSamplePos - FIRoffset;
-                if (stereo)
-                    readFadeSampleRF32 = SampleDataFR + fadeSamplePos - FIRoffset;
-            }
+    // See comment above - the generator wants a readOffset centered data set
+    readSampleL = SampleDataL + SamplePos - readOffset;
+    if (stereo)
+        readSampleR = SampleDataR + SamplePos - readOffset;
 
-            if (SamplePos >= WaveSize - resampFIRSize && SamplePos <= GD->loopUpperBound)
-            {
-                for (int k = 0; k < resampFIRSize; ++k)
-                {
-                    auto q = k + SamplePos - FIRoffset;
-                    if (q >= GD->loopUpperBound || q >= WaveSize)
-                        q -= LoopOffset;
-                    loopEndBufferLF32[k] = SampleDataFL[q];
-                    if (stereo)
-                        loopEndBufferRF32[k] = SampleDataFR[q];
-                }
-                readSampleLF32 = loopEndBufferLF32;
-                if (stereo)
-                    readSampleRF32 = loopEndBufferRF32;
-            }
-        }
-    }
-    else
+    if constexpr (loopActive)
     {
-        readSampleL = SampleDataL + SamplePos - FIRoffset;
-        if (stereo)
-            readSampleR = SampleDataR + SamplePos - FIRoffset;
-
-        if constexpr (loopActive)
+        if (fadeActive)
         {
-            if (fadeActive)
-            {
-                auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
-                readFadeSampleL = SampleDataL + fadeSamplePos - FIRoffset;
-                if (stereo)
-                    readFadeSampleR = SampleDataR + fadeSamplePos - FIRoffset;
-            }
+            auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
+            readFadeSampleL = SampleDataL + fadeSamplePos - readOffset;
+            if (stereo)
+                readFadeSampleR = SampleDataR + fadeSamplePos - readOffset;
+        }
 
-            if (SamplePos >= WaveSize - resampFIRSize && SamplePos <= GD->loopUpperBound)
+        if (SamplePos >= WaveSize - resampFIRSize && SamplePos <= GD->loopUpperBound)
+        {
+            for (int k = 0; k < resampFIRSize; ++k)
             {
-                for (int k = 0; k < resampFIRSize; ++k)
-                {
-                    auto q = k + SamplePos - FIRoffset;
-                    if (q >= GD->loopUpperBound || q >= WaveSize)
-                        q -= LoopOffset;
+                auto q = k + SamplePos - readOffset;
+                if (q >= GD->loopUpperBound || q >= WaveSize)
+                    q -= LoopOffset;
 
-                    loopEndBufferL[k] = SampleDataL[q];
-                    if (stereo)
-                        loopEndBufferR[k] = SampleDataR[q];
-                }
-                readSampleL = loopEndBufferL;
+                loopEndBufferL[k] = SampleDataL[q];
                 if (stereo)
-                    readSampleR = loopEndBufferR;
+                    loopEndBufferR[k] = SampleDataR[q];
             }
+            readSampleL = loopEndBufferL;
+            if (stereo)
+                readSampleR = loopEndBufferR;
         }
     }
 
     int NSamples = GD->blockSize;
 
     int i{0};
-    for (i = 0; i < NSamples && !IsFinished; i++)
+    while (i < NSamples && !IsFinished)
     {
+        /*
+         * Between loop points, bounds and fades the generator is just a fixed step
+         * through the sample, so render the longest run we can as a block and only
+         * fall through to the per sample path for the sample which crosses an edge.
+         */
+        auto step = Ratio * Direction;
+        int run{0};
+        if constexpr (withRuns)
+            run = runLength<loopActive, loopForward, loopWhileGated, interpolation>(
+                GD, SamplePos, SampleSubPos, step, fadeActive, WaveSize, NSamples - i);
+        if (run > 0)
+        {
+            float *out[2]{OutputL + i, stereo ? OutputR + i : nullptr};
+            const T *data[2]{SampleDataL, SampleDataR};
+            generatorRun<T, stereo ? 2 : 1, interpolation>(data, SamplePos, SampleSubPos, step,
+                                                           out, run);
+            advanceSamplePosition(SamplePos, SampleSubPos, step, run);
+            i += run;
+
+            // A run never ends in the loop end window or a fade so these are the plain reads
+            readSampleL = SampleDataL + SamplePos - readOffset;
+            if (stereo)
+                readSampleR = SampleDataR + SamplePos - readOffset;
+            continue;
+        }
+
 #define KPStereo(E, T, C, dataL, dataR, fadeL, fadeR)                                              \
-    KernelProcessor<E, T, C, loopActive> kp{                                                       \
+    KernelProcessor<E, T, C, hasFade> kp{                                                          \
         SamplePos,  SampleSubPos, int32_t(m0),        i, {dataL, dataR}, {fadeL, fadeR},           \
         fadeActive, loopFade,     {OutputL, OutputR}, IO};                                         \
     kp.ProcessKernel(GD);
 
 #define KPMono(E, T, C, data, fade)                                                                \
-    KernelProcessor<E, T, C, loopActive> ks{                                                       \
+    KernelProcessor<E, T, C, hasFade> ks{                                                          \
         SamplePos, SampleSubPos, int32_t(m0), i,         {data},                                   \
         {fade},    fadeActive,   loopFade,    {OutputL}, IO};                                      \
     ks.ProcessKernel(GD);
 
-        using type_from_cond = typename std::conditional<fp, float, int16_t>::type;
-        type_from_cond *readL, *readFadeL, *readR, *readFadeR;
-        if constexpr (fp)
-        {
-            readL = readSampleLF32;
-            readR = readSampleRF32;
-            readFadeL = readFadeSampleLF32;
-            readFadeR = readFadeSampleRF32;
-        }
-        else
-        {
-            readL = readSampleL;
-            readR = readSampleR;
-            readFadeL = readFadeSampleL;
-            readFadeR = readFadeSampleR;
-        }
-
         // 2. Resample
         unsigned int m0 = ((SampleSubPos >> 12) & 0xff0);
-        if (stereo)
+        if constexpr (stereo)
         {
-            switch (GD->interpolationType)
-            {
-            case InterpolationTypes::Sinc:
-            {
-                KPStereo(InterpolationTypes::Sinc, type_from_cond, 2, readL, readR, readFadeL,
-                         readFadeR);
-                break;
-            }
-            case InterpolationTypes::Linear:
-            {
-                KPStereo(InterpolationTypes::Linear, type_from_cond, 2, readL, readR, readFadeL,
-                         readFadeR);
-                break;
-            }
-            case InterpolationTypes::ZeroOrderHold:
-            {
-                KPStereo(InterpolationTypes::ZeroOrderHold, type_from_cond, 2, readL, readR,
-                         readFadeL, readFadeR);
-                break;
-            }
-            }
+            KPStereo(interpolation, T, 2, readSampleL, readSampleR, readFadeSampleL,
+                     readFadeSampleR);
         }
         else
         {
-            switch (GD->interpolationType)
-            {
-            case InterpolationTypes::Sinc:
-            {
-                KPMono(InterpolationTypes::Sinc, type_from_cond, 1, readL, readFadeL);
-                break;
-            }
-            case InterpolationTypes::Linear:
-            {
-                KPMono(InterpolationTypes::Linear, type_from_cond, 1, readL, readFadeL);
-                break;
-            }
-            case InterpolationTypes::ZeroOrderHold:
-            {
-                KPMono(InterpolationTypes::ZeroOrderHold, type_from_cond, 1, readL, readFadeL);
-                break;
-            }
-            }
+            KPMono(interpolation, T, 1, readSampleL, readFadeSampleL);
         }
 
 #define DEBUG_OUTPUT_MINMAX 0
@@ -818,18 +1345,9 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
                     IsFinished = true;
             }
 
-            if constexpr (fp)
-            {
-                readSampleLF32 = SampleDataFL + SamplePos - FIRoffset;
-                if (stereo)
-                    readSampleRF32 = SampleDataFR + SamplePos - FIRoffset;
-            }
-            else
-            {
-                readSampleL = SampleDataL + SamplePos - FIRoffset;
-                if (stereo)
-                    readSampleR = SampleDataR + SamplePos - FIRoffset;
-            }
+            readSampleL = SampleDataL + SamplePos - readOffset;
+            if (stereo)
+                readSampleR = SampleDataR + SamplePos - readOffset;
         }
         else if constexpr (!loopWhileGated && loopForward)
         {
@@ -948,70 +1466,35 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
 
         if constexpr (loopActive)
         {
-            if constexpr (fp)
+            // we need both checks because if we are just doing a post-release playdown
+            // we don't want to re-pad
+            if (SamplePos >= WaveSize - resampFIRSize && SamplePos <= GD->loopUpperBound)
             {
-                if (SamplePos >= WaveSize - resampFIRSize && SamplePos <= GD->loopUpperBound)
-                {
-                    for (int k = 0; k < resampFIRSize; ++k)
-                    {
-                        auto q = k + SamplePos - FIRoffset;
-                        if (q >= GD->loopUpperBound || q >= WaveSize)
-                            q -= LoopOffset;
-                        loopEndBufferLF32[k] = SampleDataFL[q];
-                        if (stereo)
-                            loopEndBufferRF32[k] = SampleDataFR[q];
-                    }
-                    readSampleLF32 = loopEndBufferLF32;
-                    if (stereo)
-                        readSampleRF32 = loopEndBufferRF32;
-                }
-                else
+                for (int k = 0; k < resampFIRSize; ++k)
                 {
-                    readSampleLF32 = SampleDataFL + SamplePos - FIRoffset;
+                    auto q = k + SamplePos - readOffset;
+                    if (q >= GD->loopUpperBound || q >= WaveSize)
+                        q -= LoopOffset;
+                    loopEndBufferL[k] = SampleDataL[q];
                     if (stereo)
-                        readSampleRF32 = SampleDataFR + SamplePos - FIRoffset;
-
-                    if (fadeActive)
-                    {
-                        auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
-                        readFadeSampleLF32 = SampleDataFL + fadeSamplePos - FIRoffset;
-                        if (stereo)
-                            readFadeSampleRF32 = SampleDataFR + fadeSamplePos - FIRoffset;
-                    }
+                        loopEndBufferR[k] = SampleDataR[q];
                 }
+                readSampleL = loopEndBufferL;
+                if (stereo)
+                    readSampleR = loopEndBufferR;
             }
             else
             {
-                // we need both checks because if we are just doing a post-release playdown
-                // we don't want to re-pad
-                if (SamplePos >= WaveSize - resampFIRSize && SamplePos <= GD->loopUpperBound)
-                {
-                    for (int k = 0; k < resampFIRSize; ++k)
-                    {
-                        auto q = k + SamplePos - FIRoffset;
-                        if (q >= GD->loopUpperBound || q >= WaveSize)
-                            q -= LoopOffset;
-                        loopEndBufferL[k] = SampleDataL[q];
-                        if (stereo)
-                            loopEndBufferR[k] = SampleDataR[q];
-                    }
-                    readSampleL = loopEndBufferL;
-                    if (stereo)
-                        readSampleR = loopEndBufferR;
-                }
-                else
+                readSampleL = SampleDataL + SamplePos - readOffset;
+                if (stereo)
+                    readSampleR = SampleDataR + SamplePos - readOffset;
+
+                if (fadeActive)
                 {
-                    readSampleL = SampleDataL + SamplePos - FIRoffset;
+                    auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
+                    readFadeSampleL = SampleDataL + fadeSamplePos - readOffset;
                     if (stereo)
-                        readSampleR = SampleDataR + SamplePos - FIRoffset;
-
-                    if (fadeActive)
-                    {
-                        auto fadeSamplePos{GD->loopLowerBound - (GD->loopUpperBound - SamplePos)};
-                        readFadeSampleL = SampleDataL + fadeSamplePos - FIRoffset;
-                        if (stereo)
-                            readFadeSampleR = SampleDataR + fadeSamplePos - FIRoffset;
-                    }
+                        readFadeSampleR = SampleDataR + fadeSamplePos - readOffset;
                 }
             }
         }
@@ -1021,6 +1504,7 @@ void GeneratorSample(GeneratorState *__restrict GD, GeneratorIO *__restrict IO)
             fadeActive = fadeActive && (SamplePos > (GD->loopUpperBound - loopFade)) &&
                          (SamplePos <= GD->loopUpperBound);
         }
+        i++;
     }
 
     // Clean up any items left
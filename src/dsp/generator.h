@@ -32,6 +32,7 @@
 #include "configuration.h"
 #include "string"
 #include "utils.h"
+#include "sample_formats.h"
 
 namespace scxt::dsp
 {
@@ -40,7 +41,10 @@ enum InterpolationTypes
 {
     Sinc,
     Linear,
-    ZeroOrderHold
+    ZeroOrderHold,
+    Hermite,      // 4 point cubic, cheaper than Sinc
+    Polyphase,    // polyphaseTaps wide windowed sinc, for when quality matters more than CPU
+    PolyphaseLong // polyphaseLongTaps wide, for when it matters a lot more
 };
 DECLARE_ENUM_STRING(InterpolationTypes);
 
@@ -54,6 +58,12 @@ inline std::string toStringInterpolationTypes(const InterpolationTypes &p)
         return "lin";
     case ZeroOrderHold:
         return "zho";
+    case Hermite:
+        return "herm";
+    case Polyphase:
+        return "poly";
+    case PolyphaseLong:
+        return "polylong";
     }
     return "sinc";
 }
@@ -61,7 +71,7 @@ inline std::string toStringInterpolationTypes(const InterpolationTypes &p)
 inline InterpolationTypes fromStringInterpolationTypes(const std::string &s)
 {
     static auto inverse = makeEnumInverse<InterpolationTypes, toStringInterpolationTypes>(
-        InterpolationTypes::Sinc, InterpolationTypes::ZeroOrderHold);
+        InterpolationTypes::Sinc, InterpolationTypes::PolyphaseLong);
     auto p = inverse.find(s);
     if (p == inverse.end())
         return Sinc;
@@ -109,8 +119,19 @@ struct GeneratorIO
 
 typedef void (*GeneratorFPtr)(GeneratorState *__restrict, GeneratorIO *__restrict);
 // TODO Loop Mode should be an enum
-GeneratorFPtr GetFPtrGeneratorSample(bool isStereo, bool isFloat, bool loopActive, bool loopForward,
-                                     bool loopWhileGated);
+GeneratorFPtr GetFPtrGeneratorSample(bool isStereo, SampleDataFormat format, bool loopActive,
+                                     bool loopForward, bool loopWhileGated,
+                                     InterpolationTypes interpolation, bool loopHasFade);
+
+/*
+ * The same generators without runs, rendering every sample through the per sample
+ * kernel. Voices never use these; they are what the tests hold the runs to.
+ */
+GeneratorFPtr GetFPtrGeneratorSamplePerSample(bool isStereo, SampleDataFormat format,
+                                              bool loopActive, bool loopForward,
+                                              bool loopWhileGated,
+                                              InterpolationTypes interpolation,
+                                              bool loopHasFade);
 
 } // namespace scxt::dsp
 #endif // SCXT_SRC_DSP_GENERATOR_H
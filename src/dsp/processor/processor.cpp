@@ -29,7 +29,9 @@
 #include "datamodel/metadata.h"
 #include "processor_defs.h"
 
+#include <algorithm>
 #include <functional>
+#include <memory>
 #include <new>
 #include <cassert>
 #include <unordered_map>
@@ -298,6 +300,30 @@ void unspawnProcessor(Processor *f)
     f->~Processor();
 }
 
+void preReserveAllProcessorPools(engine::MemoryPool *mp)
+{
+    auto memory = std::make_unique<uint8_t[]>(processorMemoryBufferSize);
+    for (auto i = 0U; i < (size_t)ProcessorType::proct_num_types; ++i)
+    {
+        auto pt = (ProcessorType)i;
+        if (pt == proct_none || !isProcessorImplemented(pt))
+            continue;
+
+        ProcessorStorage ps;
+        ps.type = pt;
+        float fp[maxProcessorFloatParams];
+        int ip[maxProcessorIntParams];
+        std::copy(ps.floatParams.begin(), ps.floatParams.end(), fp);
+        std::copy(ps.intParams.begin(), ps.intParams.end(), ip);
+        for (auto oversample : {false, true})
+        {
+            auto *p = spawnProcessorInPlace(pt, mp, memory.get(), processorMemoryBufferSize, ps,
+                                            fp, ip, oversample, false);
+            unspawnProcessor(p);
+        }
+    }
+}
+
 ProcessorControlDescription Processor::getControlDescription() const
 {
     ProcessorControlDescription res;
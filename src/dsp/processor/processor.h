@@ -311,6 +311,7 @@ struct Processor : MoveableOnly<Processor>, SampleRateSupport
     //
     // protected:
     engine::MemoryPool *memoryPool{nullptr};
+    bool usesMemoryPool{false}; // set once we reserve or check out a block
     float *param{nullptr};
     int *iparam{nullptr};
     const bool *deactivated{nullptr};
@@ -338,6 +339,13 @@ Processor *spawnProcessorInPlace(ProcessorType id, engine::MemoryPool *mp, uint8
  */
 void unspawnProcessor(Processor *f);
 
+/**
+ * Spawn every implemented processor once, at both oversample settings, so each
+ * registers the memory pool size classes it will ask for. Call this off the audio
+ * thread at startup; the classes are filled by the next MemoryPool::refill.
+ */
+void preReserveAllProcessorPools(engine::MemoryPool *mp);
+
 typedef uint8_t unimpl_t;
 template <ProcessorType ft> struct ProcessorImplementor
 {
@@ -44,6 +44,7 @@ template <int OSFactor> struct SCXTVFXConfig
 
     static void preReservePool(BaseClass *b, size_t s)
     {
+        b->usesMemoryPool = true;
         if (b->memoryPool)
         {
             b->memoryPool->preReservePool(s);
@@ -64,6 +65,7 @@ template <int OSFactor> struct SCXTVFXConfig
     static uint8_t *checkoutBlock(BaseClass *b, size_t s)
     {
         assert(b->memoryPool);
+        b->usesMemoryPool = true;
         return b->memoryPool->checkoutBlock(s);
     }
 
@@ -0,0 +1,169 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "warm_processor_pool.h"
+#include <cassert>
+
+#include "engine/memory_pool.h"
+
+namespace scxt::dsp::processor
+{
+WarmProcessorPool::WarmProcessorPool(WarmProcessorPool &&other) noexcept
+    : instances(other.instances), typeUsesMemoryPool(other.typeUsesMemoryPool),
+      memoryPool(other.memoryPool), budget(other.budget)
+{
+    other.instances = {};
+    other.memoryPool = nullptr;
+    other.budget = nullptr;
+}
+
+WarmProcessorPool::~WarmProcessorPool()
+{
+    for (auto &row : instances)
+    {
+        for (auto &inst : row)
+        {
+            assert(!inst.inUse);
+            retire(inst);
+        }
+    }
+}
+
+void WarmProcessorPool::retire(Instance &inst)
+{
+    if (inst.processor && !inst.inUse)
+    {
+        assert(budget);
+        budget->idleInstances--;
+    }
+    unspawnProcessor(inst.processor);
+    if (inst.block)
+    {
+        assert(memoryPool);
+        memoryPool->returnBlock(inst.block, processorMemoryBufferSize);
+    }
+    inst = {};
+}
+
+Processor *WarmProcessorPool::acquire(int slot, engine::MemoryPool *mp, WarmProcessorBudget *b,
+                                      const ProcessorStorage &ps, float *fp, int *ip,
+                                      bool oversample)
+{
+    if (ps.type == proct_none || !typeUsesMemoryPool[ps.type])
+        return nullptr;
+    budget = b;
+
+    auto &row = instances[slot];
+    for (auto &inst : row)
+    {
+        if (!inst.inUse && inst.processor && inst.type == ps.type && inst.oversample == oversample)
+        {
+            budget->idleInstances--;
+            inst.inUse = true;
+            inst.processor->param = fp;
+            inst.processor->iparam = ip;
+            return inst.processor;
+        }
+    }
+
+    // Nothing warm, so take an empty instance or failing that an idle one of another type
+    Instance *target{nullptr};
+    for (auto &inst : row)
+    {
+        if (!inst.inUse && !inst.processor)
+        {
+            target = &inst;
+            break;
+        }
+    }
+    if (!target)
+    {
+        for (auto &inst : row)
+        {
+            if (!inst.inUse)
+            {
+                target = &inst;
+                break;
+            }
+        }
+    }
+    if (!target)
+        return nullptr;
+
+    memoryPool = mp;
+    if (target->processor)
+        budget->idleInstances--;
+    unspawnProcessor(target->processor);
+    if (!target->block)
+        target->block = mp->checkoutBlock(processorMemoryBufferSize);
+
+    target->processor = spawnProcessorInPlace(ps.type, mp, target->block,
+                                              processorMemoryBufferSize, ps, fp, ip, oversample,
+                                              false);
+    target->type = ps.type;
+    target->oversample = oversample;
+    target->inUse = true;
+    return target->processor;
+}
+
+bool WarmProcessorPool::release(Processor *p)
+{
+    if (!p)
+        return true;
+
+    for (auto &row : instances)
+    {
+        for (auto &inst : row)
+        {
+            if (inst.processor == p)
+            {
+                assert(inst.inUse);
+                // Over budget we let it go now, while it still counts as in use
+                if (budget->idleInstances >= WarmProcessorBudget::maxIdleInstances)
+                    retire(inst);
+                else
+                    budget->idleInstances++;
+                inst.inUse = false;
+                return true;
+            }
+        }
+    }
+
+    if (p->usesMemoryPool)
+        typeUsesMemoryPool[p->getType()] = true;
+    return false;
+}
+
+void WarmProcessorPool::dropIdle(int slot)
+{
+    for (auto &inst : instances[slot])
+    {
+        if (!inst.inUse)
+            retire(inst);
+    }
+}
+} // namespace scxt::dsp::processor
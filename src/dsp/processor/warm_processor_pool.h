@@ -0,0 +1,109 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_DSP_PROCESSOR_WARM_PROCESSOR_POOL_H
+#define SCXT_SRC_DSP_PROCESSOR_WARM_PROCESSOR_POOL_H
+
+#include <array>
+#include <atomic>
+
+#include "configuration.h"
+#include "utils.h"
+#include "processor.h"
+
+namespace scxt::engine
+{
+struct MemoryPool;
+}
+
+namespace scxt::dsp::processor
+{
+/*
+ * Processors which take blocks from the memory pool (delay lines and the like) are
+ * costly to construct, init and tear down, and a voice does all of that for every
+ * note. So a zone keeps some warm instances of those types per processor slot. They
+ * live in memory pool blocks, and when a voice is done with one it stays constructed,
+ * holding its blocks, until the next voice adopts it, rebinds the parameters and
+ * re-inits it.
+ *
+ * We learn which types are heavy as voices release them; everything else keeps
+ * spawning into the voice. acquire and release are called on the audio thread. The
+ * destructor runs wherever the zone is freed, which is usually the serialization thread.
+ *
+ * Idle instances across every zone count against the engine's WarmProcessorBudget.
+ * A voice releasing an instance once the budget is spent retires it rather than keeping
+ * it warm, so the memory held idle is bounded however many zones there are. Since a
+ * zone being freed retires its instances off the audio thread, the count is atomic.
+ */
+struct WarmProcessorBudget
+{
+    static constexpr int32_t maxIdleInstances{64};
+    std::atomic<int32_t> idleInstances{0};
+};
+
+struct WarmProcessorPool : MoveableOnly<WarmProcessorPool>
+{
+    static constexpr size_t instancesPerSlot{8};
+
+    WarmProcessorPool() = default;
+    WarmProcessorPool(WarmProcessorPool &&other) noexcept;
+    ~WarmProcessorPool();
+
+    /*
+     * A warm (or newly spawned pooled) instance of ps.type bound to fp and ip, or nullptr
+     * if the type doesn't use the pool or the slot is full, in which case the voice
+     * should spawn its own. The caller still sets sample rate and tempo and calls init()
+     * exactly as it would for a fresh spawn.
+     */
+    Processor *acquire(int slot, engine::MemoryPool *mp, WarmProcessorBudget *budget,
+                       const ProcessorStorage &ps, float *fp, int *ip, bool oversample);
+
+    // Returns false if p isn't one of ours, in which case the caller unspawns it
+    bool release(Processor *p);
+
+    // Drops the idle instances in a slot, for instance when its type changes
+    void dropIdle(int slot);
+
+  private:
+    struct Instance
+    {
+        uint8_t *block{nullptr};
+        Processor *processor{nullptr};
+        ProcessorType type{proct_none};
+        bool oversample{false};
+        bool inUse{false};
+    };
+    void retire(Instance &inst);
+
+    std::array<std::array<Instance, instancesPerSlot>, processorsPerZoneAndGroup> instances{};
+    std::array<bool, proct_num_types> typeUsesMemoryPool{};
+    engine::MemoryPool *memoryPool{nullptr};
+    WarmProcessorBudget *budget{nullptr};
+};
+} // namespace scxt::dsp::processor
+
+#endif // SHORTCIRCUITXT_WARM_PROCESSOR_POOL_H
@@ -37,5 +37,14 @@ static constexpr uint32_t FIRipol_M = 256;
 static constexpr uint32_t FIRipol_N = 16;
 static constexpr uint32_t FIRipolI16_N = 16;
 static constexpr uint32_t FIRoffset = 8;
+
+// The Polyphase interpolators' kernels
+static constexpr uint32_t polyphaseTaps = 32;
+static constexpr uint32_t polyphaseLongTaps = 64;
+static constexpr uint32_t polyphasePhases = 256;
+
+// Sample data, and every window a voice reads it through, has this many frames either
+// side of it so the widest kernel can run right up to the edges
+static constexpr uint32_t samplePadding = polyphaseLongTaps / 2;
 } // namespace scxt::dsp
 #endif // SCXT_SRC_DSP_RESAMPLING_H
@@ -26,65 +26,130 @@
  */
 
 #include "sample_analytics.h"
+#include <algorithm>
 #include <limits>
 #include <cmath>
+#include <vector>
 
 namespace scxt::dsp::sample_analytics
 {
-float computePeak(const std::shared_ptr<sample::Sample> &s)
+namespace
+{
+// Sums over the frames of one float buffer per channel
+struct LevelAccumulator
 {
-    float peak = 0.0f;
-    for (size_t i = 0; i < s->getSampleLength(); i++)
+    float peak{0.f};
+    double sumOfSquares{0.0};
+    void add(const float *d, int64_t n)
     {
-        for (int chan = 0; chan < s->channels; chan++)
+        for (int64_t i = 0; i < n; ++i)
         {
-            float sample = 0.0;
-            switch (s->bitDepth)
-            {
-            case sample::Sample::BD_I16:
-                sample = static_cast<float>(s->GetSamplePtrI16(chan)[i]) /
-                         std::numeric_limits<int16_t>::max();
-                break;
-            case sample::Sample::BD_F32:
-                sample = s->GetSamplePtrF32(chan)[i];
-                break;
-            }
-            peak = std::max(peak, std::abs(sample));
+            peak = std::max(peak, std::abs(d[i]));
+            sumOfSquares += (double)d[i] * d[i];
         }
     }
-    return peak;
+};
+
+float residentSampleAt(sample::Sample &s, int chan, size_t i)
+{
+    switch (s.bitDepth)
+    {
+    case sample::Sample::BD_I16:
+        return static_cast<float>(s.GetSamplePtrI16(chan)[i]) /
+               std::numeric_limits<int16_t>::max();
+    case sample::Sample::BD_F32:
+        return s.GetSamplePtrF32(chan)[i];
+    case sample::Sample::BD_I24:
+        return normalizedI24(s.GetSamplePtrI24(chan)[i]);
+    case sample::Sample::BD_I8:
+        return normalizedI8(s.GetSamplePtrI8(chan)[i]);
+    }
+    return 0.f;
 }
+} // namespace
 
-float computeRMS(const std::shared_ptr<sample::Sample> &s)
+void cacheLevels(sample::Sample &s)
 {
-    float ms = 0.0f;
-    const float divisor_recip =
-        1.0f / (static_cast<float>(s->channels) * static_cast<float>(s->getSampleLength()));
-    for (size_t i = 0; i < s->getSampleLength(); i++)
+    LevelAccumulator acc;
+    int64_t length = s.sample_length;
+    auto chans = std::min((int)s.channels, 2);
+
+    if (s.isCompressed())
     {
-        for (int chan = 0; chan < s->channels; chan++)
+        std::vector<int32_t> scratch(sample::CompressedFrames::blockFrames);
+        std::vector<float> buf(sample::CompressedFrames::blockFrames);
+        for (int c = 0; c < chans; ++c)
         {
-            float sample = 0.0;
-            switch (s->bitDepth)
+            for (int64_t f = 0; f < length; f += (int64_t)buf.size())
             {
-            case sample::Sample::BD_I16:
-                sample = static_cast<float>(s->GetSamplePtrI16(chan)[i]) /
-                         std::numeric_limits<int16_t>::max();
-                break;
-            case sample::Sample::BD_F32:
-                sample = s->GetSamplePtrF32(chan)[i];
-                break;
+                auto n = std::min((int64_t)buf.size(), length - f);
+                s.compressedFrames->decodeFrames(c, f, f + n, true, buf.data(), scratch.data());
+                acc.add(buf.data(), n);
             }
-            ms += std::pow(sample, 2.0f) * divisor_recip;
         }
     }
+    else if (s.isStreamed && s.streamingSource)
+    {
+        // The streamer reads through the sample's own source, so open one of our own
+        const auto &src = *s.streamingSource;
+        sample::StreamingSource reader;
+        reader.encoding = src.encoding;
+        reader.path = src.path;
+        reader.dataOffset = src.dataOffset;
+        reader.channels = src.channels;
+        reader.bytesPerSample = src.bytesPerSample;
+        reader.totalFrames = src.totalFrames;
 
-    if (s->getSampleLength() > 0)
+        static constexpr int64_t chunk{65536};
+        std::vector<float> buf[2];
+        for (int c = 0; c < chans; ++c)
+            buf[c].resize(chunk);
+        for (int64_t f = 0; f < length; f += chunk)
+        {
+            auto n = std::min(chunk, length - f);
+            if (!reader.read(f, n, true, buf[0].data(), chans > 1 ? buf[1].data() : nullptr))
+            {
+                SCLOG("Unable to read " << s.getPath().u8string() << " for its levels");
+                break;
+            }
+            for (int c = 0; c < chans; ++c)
+                acc.add(buf[c].data(), n);
+        }
+    }
+    else
     {
-        return std::sqrt(ms);
+        std::vector<float> buf(std::min(length, (int64_t)65536));
+        for (int c = 0; c < chans; ++c)
+        {
+            for (int64_t f = 0; f < length; f += (int64_t)buf.size())
+            {
+                auto n = std::min((int64_t)buf.size(), length - f);
+                for (int64_t i = 0; i < n; ++i)
+                    buf[i] = residentSampleAt(s, c, f + i);
+                acc.add(buf.data(), n);
+            }
+        }
     }
 
+    s.peakLevel = acc.peak;
     // What should the RMS of an empty sample be?
-    return 0.0f;
+    s.rmsLevel = (length > 0 && chans > 0)
+                     ? (float)std::sqrt(acc.sumOfSquares / ((double)chans * length))
+                     : 0.f;
+    s.levelsCached = true;
+}
+
+float computePeak(const std::shared_ptr<sample::Sample> &s)
+{
+    if (!s->levelsCached)
+        cacheLevels(*s);
+    return s->peakLevel;
+}
+
+float computeRMS(const std::shared_ptr<sample::Sample> &s)
+{
+    if (!s->levelsCached)
+        cacheLevels(*s);
+    return s->rmsLevel;
 }
 } // namespace scxt::dsp::sample_analytics
@@ -32,6 +32,13 @@
 
 namespace scxt::dsp::sample_analytics
 {
+/*
+ * Work out the peak and RMS over every frame of s, reading a streamed sample's file or
+ * decoding a compressed one as needed, and keep them on the sample. This touches every
+ * frame, so it is left until someone asks: computePeak and computeRMS return the cached
+ * values, computing them first if need be. Call them off the audio thread.
+ */
+void cacheLevels(sample::Sample &s);
 float computePeak(const std::shared_ptr<sample::Sample> &s);
 float computeRMS(const std::shared_ptr<sample::Sample> &s);
 }; // namespace scxt::dsp::sample_analytics
@@ -0,0 +1,65 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_DSP_SAMPLE_FORMATS_H
+#define SCXT_SRC_DSP_SAMPLE_FORMATS_H
+
+#include <cstdint>
+
+namespace scxt::dsp
+{
+/*
+ * The in memory sample formats the generator can read. 24 and 8 bit material is kept at
+ * its native width rather than widened at load, and converted to float as it plays.
+ */
+enum SampleDataFormat
+{
+    SDF_I16,
+    SDF_F32,
+    SDF_I24, // PackedI24
+    SDF_I8
+};
+
+// A little endian 24 bit sample. It is three bytes wide so arrays of them are packed.
+struct PackedI24
+{
+    uint8_t b[3];
+};
+static_assert(sizeof(PackedI24) == 3);
+
+inline float normalizedI24(const PackedI24 &v)
+{
+    auto i = (int32_t)(((uint32_t)v.b[0] << 8) | ((uint32_t)v.b[1] << 16) |
+                       ((uint32_t)v.b[2] << 24)) >>
+             8;
+    return i * (1.f / 8388608.f);
+}
+
+inline float normalizedI8(int8_t v) { return v * (1.f / 128.f); }
+} // namespace scxt::dsp
+
+#endif // SHORTCIRCUITXT_SAMPLE_FORMATS_H
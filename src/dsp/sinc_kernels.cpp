@@ -0,0 +1,374 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "sinc_kernels.h"
+#include "infrastructure/sse_include.h"
+#include "data_tables.h"
+#include "resampling.h"
+#include "utils.h"
+
+#include <mutex>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SCXT_SINC_KERNELS_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SCXT_SINC_TARGET(x)
+#else
+#define SCXT_SINC_TARGET(x) __attribute__((target(x)))
+#endif
+#else
+#define SCXT_SINC_KERNELS_X86 0
+#endif
+
+namespace scxt::dsp
+{
+namespace
+{
+constexpr float i16InvScale{1.f / (16384.f * 32768.f)};
+
+inline void stepPosition(int32_t &pos, int32_t &sub, int32_t step)
+{
+    sub += step;
+    int32_t incr = sub >> 24;
+    pos += incr;
+    sub -= incr << 24;
+}
+
+/*
+ * The baseline is exactly the arithmetic of the per sample SSE kernel in the
+ * generator, just run along the whole span.
+ */
+template <int NCH>
+void sincRunF32SSE(const float *const *data, int32_t pos, int32_t sub, int32_t step,
+                   float *const *out, int n)
+{
+    for (int j = 0; j < n; ++j)
+    {
+        auto m0 = (sub >> 12) & 0xff0;
+        auto lipol0 = _mm_set1_ps((float)(sub & 0xffff));
+        __m128 coef[4];
+        for (int q = 0; q < 4; ++q)
+            coef[q] =
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&sincTable.SincOffsetF32[m0 + q * 4]), lipol0),
+                           _mm_loadu_ps(&sincTable.SincTableF32[m0 + q * 4]));
+        for (int c = 0; c < NCH; ++c)
+        {
+            auto r = data[c] + pos - FIRoffset;
+            auto s4 = _mm_mul_ps(coef[0], _mm_loadu_ps(r));
+            s4 = _mm_add_ps(s4, _mm_mul_ps(coef[1], _mm_loadu_ps(r + 4)));
+            s4 = _mm_add_ps(s4, _mm_mul_ps(coef[2], _mm_loadu_ps(r + 8)));
+            s4 = _mm_add_ps(s4, _mm_mul_ps(coef[3], _mm_loadu_ps(r + 12)));
+            s4 = _mm_hadd_ps(s4, s4);
+            s4 = _mm_hadd_ps(s4, s4);
+            _mm_store_ss(&out[c][j], s4);
+        }
+        stepPosition(pos, sub, step);
+    }
+}
+
+template <int NCH>
+void sincRunI16SSE(const int16_t *const *data, int32_t pos, int32_t sub, int32_t step,
+                   float *const *out, int n)
+{
+    for (int j = 0; j < n; ++j)
+    {
+        auto m0 = (sub >> 12) & 0xff0;
+        auto lipol0 = _mm_set1_epi16((int16_t)(sub & 0xffff));
+        auto coefA = _mm_add_epi16(
+            _mm_mulhi_epi16(_mm_loadu_si128((__m128i *)&sincTable.SincOffsetI16[m0]), lipol0),
+            _mm_loadu_si128((__m128i *)&sincTable.SincTableI16[m0]));
+        auto coefB = _mm_add_epi16(
+            _mm_mulhi_epi16(_mm_loadu_si128((__m128i *)&sincTable.SincOffsetI16[m0 + 8]), lipol0),
+            _mm_loadu_si128((__m128i *)&sincTable.SincTableI16[m0 + 8]));
+        for (int c = 0; c < NCH; ++c)
+        {
+            auto r = data[c] + pos - FIRoffset;
+            auto s = _mm_add_epi32(_mm_madd_epi16(coefA, _mm_loadu_si128((__m128i *)r)),
+                                   _mm_madd_epi16(coefB, _mm_loadu_si128((__m128i *)(r + 8))));
+            int l alignas(16)[4];
+            _mm_store_si128((__m128i *)l, s);
+            out[c][j] = (float)((l[0] + l[1]) + (l[2] + l[3])) * i16InvScale;
+        }
+        stepPosition(pos, sub, step);
+    }
+}
+
+#if SCXT_SINC_KERNELS_X86
+/*
+ * The wide kernels build eight outputs' worth of products and then reduce all eight
+ * in one hadd tree, so lane u of the result is output u.
+ */
+SCXT_SINC_TARGET("avx2,fma") inline __m256 reduceEightF32(const __m256 *v)
+{
+    auto t0 = _mm256_hadd_ps(v[0], v[1]);
+    auto t1 = _mm256_hadd_ps(v[2], v[3]);
+    auto t2 = _mm256_hadd_ps(v[4], v[5]);
+    auto t3 = _mm256_hadd_ps(v[6], v[7]);
+    auto u0 = _mm256_hadd_ps(t0, t1);
+    auto u1 = _mm256_hadd_ps(t2, t3);
+    return _mm256_add_ps(_mm256_permute2f128_ps(u0, u1, 0x20),
+                         _mm256_permute2f128_ps(u0, u1, 0x31));
+}
+
+SCXT_SINC_TARGET("avx2,fma") inline float reduceOneF32(__m256 v)
+{
+    auto s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_hadd_ps(s, s);
+    s = _mm_hadd_ps(s, s);
+    return _mm_cvtss_f32(s);
+}
+
+SCXT_SINC_TARGET("avx2,fma") inline __m256i reduceEightI32(const __m256i *v)
+{
+    auto t0 = _mm256_hadd_epi32(v[0], v[1]);
+    auto t1 = _mm256_hadd_epi32(v[2], v[3]);
+    auto t2 = _mm256_hadd_epi32(v[4], v[5]);
+    auto t3 = _mm256_hadd_epi32(v[6], v[7]);
+    auto u0 = _mm256_hadd_epi32(t0, t1);
+    auto u1 = _mm256_hadd_epi32(t2, t3);
+    return _mm256_add_epi32(_mm256_permute2x128_si256(u0, u1, 0x20),
+                            _mm256_permute2x128_si256(u0, u1, 0x31));
+}
+
+SCXT_SINC_TARGET("avx2,fma") inline void coefficientsF32AVX2(int32_t sub, __m256 &c0, __m256 &c1)
+{
+    auto m0 = (sub >> 12) & 0xff0;
+    auto lipol = _mm256_set1_ps((float)(sub & 0xffff));
+    c0 = _mm256_fmadd_ps(_mm256_loadu_ps(&sincTable.SincOffsetF32[m0]), lipol,
+                         _mm256_loadu_ps(&sincTable.SincTableF32[m0]));
+    c1 = _mm256_fmadd_ps(_mm256_loadu_ps(&sincTable.SincOffsetF32[m0 + 8]), lipol,
+                         _mm256_loadu_ps(&sincTable.SincTableF32[m0 + 8]));
+}
+
+SCXT_SINC_TARGET("avx2,fma") inline __m256 productF32AVX2(const float *r, __m256 c0, __m256 c1)
+{
+    return _mm256_fmadd_ps(c1, _mm256_loadu_ps(r + 8), _mm256_mul_ps(c0, _mm256_loadu_ps(r)));
+}
+
+SCXT_SINC_TARGET("avx2,fma") inline __m256i coefficientsI16AVX2(int32_t sub)
+{
+    auto m0 = (sub >> 12) & 0xff0;
+    auto lipol = _mm256_set1_epi16((int16_t)(sub & 0xffff));
+    return _mm256_add_epi16(
+        _mm256_mulhi_epi16(_mm256_loadu_si256((const __m256i *)&sincTable.SincOffsetI16[m0]),
+                           lipol),
+        _mm256_loadu_si256((const __m256i *)&sincTable.SincTableI16[m0]));
+}
+
+template <int NCH>
+SCXT_SINC_TARGET("avx2,fma")
+void sincRunF32AVX2(const float *const *data, int32_t pos, int32_t sub, int32_t step,
+                    float *const *out, int n)
+{
+    int j{0};
+    for (; j + 8 <= n; j += 8)
+    {
+        __m256 acc[NCH][8];
+        for (int u = 0; u < 8; ++u)
+        {
+            __m256 c0, c1;
+            coefficientsF32AVX2(sub, c0, c1);
+            for (int c = 0; c < NCH; ++c)
+                acc[c][u] = productF32AVX2(data[c] + pos - FIRoffset, c0, c1);
+            stepPosition(pos, sub, step);
+        }
+        for (int c = 0; c < NCH; ++c)
+            _mm256_storeu_ps(out[c] + j, reduceEightF32(acc[c]));
+    }
+    for (; j < n; ++j)
+    {
+        __m256 c0, c1;
+        coefficientsF32AVX2(sub, c0, c1);
+        for (int c = 0; c < NCH; ++c)
+            out[c][j] = reduceOneF32(productF32AVX2(data[c] + pos - FIRoffset, c0, c1));
+        stepPosition(pos, sub, step);
+    }
+}
+
+template <int NCH>
+SCXT_SINC_TARGET("avx2,fma")
+void sincRunI16AVX2(const int16_t *const *data, int32_t pos, int32_t sub, int32_t step,
+                    float *const *out, int n)
+{
+    const auto scale = _mm256_set1_ps(i16InvScale);
+
+    int j{0};
+    for (; j + 8 <= n; j += 8)
+    {
+        __m256i acc[NCH][8];
+        for (int u = 0; u < 8; ++u)
+        {
+            auto coef = coefficientsI16AVX2(sub);
+            for (int c = 0; c < NCH; ++c)
+                acc[c][u] = _mm256_madd_epi16(
+                    coef, _mm256_loadu_si256((const __m256i *)(data[c] + pos - FIRoffset)));
+            stepPosition(pos, sub, step);
+        }
+        for (int c = 0; c < NCH; ++c)
+            _mm256_storeu_ps(out[c] + j,
+                             _mm256_mul_ps(_mm256_cvtepi32_ps(reduceEightI32(acc[c])), scale));
+    }
+    for (; j < n; ++j)
+    {
+        auto coef = coefficientsI16AVX2(sub);
+        for (int c = 0; c < NCH; ++c)
+        {
+            auto p = _mm256_madd_epi16(
+                coef, _mm256_loadu_si256((const __m256i *)(data[c] + pos - FIRoffset)));
+            auto s = _mm_add_epi32(_mm256_castsi256_si128(p), _mm256_extracti128_si256(p, 1));
+            s = _mm_hadd_epi32(s, s);
+            s = _mm_hadd_epi32(s, s);
+            out[c][j] = (float)_mm_cvtsi128_si32(s) * i16InvScale;
+        }
+        stepPosition(pos, sub, step);
+    }
+}
+
+// With AVX-512 the whole 16 tap window is one register so each output is one multiply
+SCXT_SINC_TARGET("avx512f,avx2,fma") inline __m512 coefficientsF32AVX512(int32_t sub)
+{
+    auto m0 = (sub >> 12) & 0xff0;
+    auto lipol = _mm512_set1_ps((float)(sub & 0xffff));
+    return _mm512_fmadd_ps(_mm512_loadu_ps(&sincTable.SincOffsetF32[m0]), lipol,
+                           _mm512_loadu_ps(&sincTable.SincTableF32[m0]));
+}
+
+SCXT_SINC_TARGET("avx512f,avx2,fma") inline __m256 halveAVX512(__m512 v)
+{
+    return _mm256_add_ps(_mm512_castps512_ps256(v),
+                         _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)));
+}
+
+template <int NCH>
+SCXT_SINC_TARGET("avx512f,avx2,fma")
+void sincRunF32AVX512(const float *const *data, int32_t pos, int32_t sub, int32_t step,
+                      float *const *out, int n)
+{
+    int j{0};
+    for (; j + 8 <= n; j += 8)
+    {
+        __m256 acc[NCH][8];
+        for (int u = 0; u < 8; ++u)
+        {
+            auto coef = coefficientsF32AVX512(sub);
+            for (int c = 0; c < NCH; ++c)
+                acc[c][u] = halveAVX512(
+                    _mm512_mul_ps(coef, _mm512_loadu_ps(data[c] + pos - FIRoffset)));
+            stepPosition(pos, sub, step);
+        }
+        for (int c = 0; c < NCH; ++c)
+            _mm256_storeu_ps(out[c] + j, reduceEightF32(acc[c]));
+    }
+    for (; j < n; ++j)
+    {
+        auto coef = coefficientsF32AVX512(sub);
+        for (int c = 0; c < NCH; ++c)
+            out[c][j] = _mm512_reduce_add_ps(
+                _mm512_mul_ps(coef, _mm512_loadu_ps(data[c] + pos - FIRoffset)));
+        stepPosition(pos, sub, step);
+    }
+}
+
+enum struct X86Level
+{
+    SSE,
+    AVX2,
+    AVX512
+};
+
+X86Level detectX86Level()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuid(r, 0);
+    auto maxLeaf = r[0];
+    if (maxLeaf < 7)
+        return X86Level::SSE;
+    __cpuidex(r, 1, 0);
+    bool osxsave = r[2] & (1 << 27), avx = r[2] & (1 << 28), fma = r[2] & (1 << 12);
+    if (!(osxsave && avx && fma))
+        return X86Level::SSE;
+    auto xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6)
+        return X86Level::SSE;
+    __cpuidex(r, 7, 0);
+    bool avx2 = r[1] & (1 << 5), avx512f = r[1] & (1 << 16);
+    if (avx512f && (xcr0 & 0xe6) == 0xe6)
+        return X86Level::AVX512;
+    return avx2 ? X86Level::AVX2 : X86Level::SSE;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("fma"))
+        return X86Level::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return X86Level::AVX2;
+    return X86Level::SSE;
+#endif
+}
+#endif
+
+template <typename T, void (*F1)(const T *const *, int32_t, int32_t, int32_t, float *const *, int),
+          void (*F2)(const T *const *, int32_t, int32_t, int32_t, float *const *, int)>
+void sincRunByChannels(const T *const *data, int channels, int32_t pos, int32_t sub, int32_t step,
+                       float *const *out, int n)
+{
+    if (channels == 2)
+        F2(data, pos, sub, step, out, n);
+    else
+        F1(data, pos, sub, step, out, n);
+}
+} // namespace
+
+SincKernels sincKernels{sincRunByChannels<float, sincRunF32SSE<1>, sincRunF32SSE<2>>,
+                        sincRunByChannels<int16_t, sincRunI16SSE<1>, sincRunI16SSE<2>>, "sse"};
+
+void SincKernels::init()
+{
+    // Every Engine calls this, but only the first may write, since later ones run
+    // alongside audio threads reading us
+    static std::once_flag selected;
+    std::call_once(selected, [this]() {
+#if SCXT_SINC_KERNELS_X86
+        auto level = detectX86Level();
+        if (level == X86Level::AVX2 || level == X86Level::AVX512)
+        {
+            runF32 = sincRunByChannels<float, sincRunF32AVX2<1>, sincRunF32AVX2<2>>;
+            runI16 = sincRunByChannels<int16_t, sincRunI16AVX2<1>, sincRunI16AVX2<2>>;
+            name = "avx2";
+        }
+        if (level == X86Level::AVX512)
+        {
+            // int16 stays on AVX2; the 16 bit multiplies at 512 need AVX-512BW
+            runF32 = sincRunByChannels<float, sincRunF32AVX512<1>, sincRunF32AVX512<2>>;
+            name = "avx512";
+        }
+#endif
+        SCLOG("Sinc interpolation kernels: " << name);
+    });
+}
+} // namespace scxt::dsp
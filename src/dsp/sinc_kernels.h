@@ -0,0 +1,91 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_DSP_SINC_KERNELS_H
+#define SCXT_SRC_DSP_SINC_KERNELS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+namespace scxt::dsp
+{
+/*
+ * Wide sinc kernels. Rather than one output per call, these render a run of n
+ * consecutive outputs for one or two channels from a starting position and a fixed
+ * signed step (ratio times direction, in the generator's 8.24 fixed point). The
+ * coefficients for each output are built once and shared by both channels, and the
+ * wide implementations reduce eight outputs at a time rather than one.
+ *
+ * data points at the top of each channel's sample in the usual padded
+ * buffer, and the caller guarantees every position in the run is inside the playback
+ * bounds so no loop or clamp handling is needed. The implementation is chosen from the
+ * CPU (AVX-512, AVX2 with FMA, or the SSE / simde baseline) when the Engine is built.
+ */
+using sincRunF32_t = void (*)(const float *const *data, int channels, int32_t samplePos,
+                              int32_t sampleSubPos, int32_t step, float *const *out, int n);
+using sincRunI16_t = void (*)(const int16_t *const *data, int channels, int32_t samplePos,
+                              int32_t sampleSubPos, int32_t step, float *const *out, int n);
+
+struct SincKernels
+{
+    sincRunF32_t runF32{nullptr};
+    sincRunI16_t runI16{nullptr};
+    const char *name{"sse"};
+
+    // Select the widest kernels the CPU runs. Until this is called we run the baseline.
+    void init();
+};
+extern SincKernels sincKernels;
+
+// Advance an 8.24 position by n steps, exactly as stepping one output at a time does
+inline void advanceSamplePosition(int32_t &samplePos, int32_t &sampleSubPos, int32_t step, int n)
+{
+    auto total = (int64_t)sampleSubPos + (int64_t)step * n;
+    auto incr = total >> 24;
+    samplePos += (int32_t)incr;
+    sampleSubPos = (int32_t)(total - (incr << 24));
+}
+
+// How many steps from (samplePos, sampleSubPos) stay within [lower, upper], up to n
+inline int boundedRunLength(int32_t samplePos, int32_t sampleSubPos, int32_t step,
+                            int32_t lower, int32_t upper, int n)
+{
+    if (samplePos < lower || samplePos > upper)
+        return 0;
+    if (step == 0)
+        return n;
+    int64_t room;
+    if (step > 0)
+        room = (((int64_t)(upper - samplePos + 1)) << 24) - 1 - sampleSubPos;
+    else
+        room = (((int64_t)(samplePos - lower)) << 24) + sampleSubPos;
+    return (int)std::min((int64_t)n, room / std::abs((int64_t)step));
+}
+} // namespace scxt::dsp
+
+#endif // SHORTCIRCUITXT_SINC_KERNELS_H
@@ -61,18 +61,21 @@ namespace dtl
 {
 struct EngineBiquadAdapter
 {
-    static inline float dbToLinear(Engine *e, float f) { return dsp::dbTable.dbToLinear(f); }
-    static inline float noteToPitchIgnoringTuning(Engine *e, float f)
+    static inline float dbToLinear(BusEffectGlobals *g, float f)
+    {
+        return dsp::dbTable.dbToLinear(f);
+    }
+    static inline float noteToPitchIgnoringTuning(BusEffectGlobals *g, float f)
     {
         return tuning::equalTuning.note_to_pitch(f);
     }
-    static inline float sampleRateInv(Engine *e) { return e->getSampleRateInv(); }
+    static inline float sampleRateInv(BusEffectGlobals *g) { return g->engine->getSampleRateInv(); }
 };
 struct Config
 {
     static constexpr int blockSize{scxt::blockSize};
     using BaseClass = BusEffect;
-    using GlobalStorage = Engine;
+    using GlobalStorage = BusEffectGlobals;
     using EffectStorage = BusEffectStorage;
     using ValueStorage = float;
 
@@ -91,13 +94,13 @@ struct Config
 
     static inline float envelopeRateLinear(GlobalStorage *s, float f)
     {
-        return blockSize * s->getSampleRateInv() * dsp::twoToTheXTable.twoToThe(-f);
+        return blockSize * s->engine->getSampleRateInv() * dsp::twoToTheXTable.twoToThe(-f);
     }
 
     static inline float temposyncRatio(GlobalStorage *s, EffectStorage *e, int idx)
     {
         if (e->isTemposync)
-            return s->transport.tempo / 120.f;
+            return s->engine->transport.tempo / 120.f;
         else
             return 1.f;
     }
@@ -105,9 +108,10 @@ struct Config
     static inline bool isDeactivated(EffectStorage *e, int idx) { return e->isExtended(idx); }
     static inline bool isExtended(EffectStorage *e, int idx) { return e->isExtended(idx); }
 
+    // Part busses process on render pool workers, so each bus has its own generator
     static inline float rand01(GlobalStorage *s) { return s->rng.unif01(); }
 
-    static inline double sampleRate(GlobalStorage *s) { return s->getSampleRate(); }
+    static inline double sampleRate(GlobalStorage *s) { return s->engine->getSampleRate(); }
 
     static inline float noteToPitch(GlobalStorage *s, float p)
     {
@@ -132,7 +136,10 @@ template <typename T> struct Impl : T
     Engine *engine{nullptr};
     BusEffectStorage *pes{nullptr};
     float *values{nullptr};
-    Impl(Engine *e, BusEffectStorage *f, float *v) : engine(e), pes(f), values(v), T(e, f, v) {}
+    Impl(BusEffectGlobals *g, BusEffectStorage *f, float *v)
+        : engine(g->engine), pes(f), values(v), T(g, f, v)
+    {
+    }
     void init(bool defaultsOverride) override
     {
         if (defaultsOverride)
@@ -157,7 +164,8 @@ template <typename T> struct Impl : T
 } // namespace dtl
 
 // TODO consider the enum to type trick so these can skip the switch
-std::unique_ptr<BusEffect> createEffect(AvailableBusEffects p, Engine *e, BusEffectStorage *s)
+std::unique_ptr<BusEffect> createEffect(AvailableBusEffects p, BusEffectGlobals *e,
+                                        BusEffectStorage *s)
 {
     namespace sfx = sst::effects;
     if (s)
@@ -199,7 +207,8 @@ std::unique_ptr<BusEffect> createEffect(AvailableBusEffects p, Engine *e, BusEff
 void Bus::setBusEffectType(Engine &e, int idx, scxt::engine::AvailableBusEffects t)
 {
     assert(idx >= 0 && idx < maxEffectsPerBus);
-    busEffects[idx] = createEffect(t, &e, &busEffectStorage[idx]);
+    effectGlobals.engine = &e;
+    busEffects[idx] = createEffect(t, &effectGlobals, &busEffectStorage[idx]);
     if (busEffects[idx])
         busEffects[idx]->init(true);
 }
@@ -208,7 +217,9 @@ void Bus::initializeAfterUnstream(Engine &e)
 {
     for (int idx = 0; idx < maxEffectsPerBus; ++idx)
     {
-        busEffects[idx] = createEffect(busEffectStorage[idx].type, &e, &busEffectStorage[idx]);
+        effectGlobals.engine = &e;
+        busEffects[idx] =
+            createEffect(busEffectStorage[idx].type, &effectGlobals, &busEffectStorage[idx]);
         if (busEffects[idx])
         {
             busEffects[idx]->init(false);
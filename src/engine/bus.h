@@ -52,6 +52,7 @@
 #include "utils.h"
 #include "datamodel/metadata.h"
 #include "sst/filters/HalfRateFilter.h"
+#include "sst/basic-blocks/dsp/RNG.h"
 
 namespace scxt::engine
 {
@@ -108,9 +109,19 @@ struct BusEffectStorage
     inline bool isDeactivated(int idx) { return deact[idx]; }
     inline bool isExtended(int idx) { return false; }
 };
+/*
+ * What a bus's effects see as their global storage. Busses process on different render
+ * workers, so the state effects change as they run (their random numbers) is per bus.
+ */
+struct BusEffectGlobals
+{
+    Engine *engine{nullptr};
+    sst::basic_blocks::dsp::RNG rng;
+};
+
 struct BusEffect
 {
-    BusEffect(Engine *, BusEffectStorage *, float *) {}
+    BusEffect(BusEffectGlobals *, BusEffectStorage *, float *) {}
     virtual ~BusEffect() = default;
 
     virtual void init(bool defaultsOverrideStorage) = 0;
@@ -120,7 +131,8 @@ struct BusEffect
     virtual void onSampleRateChanged() = 0;
 };
 
-std::unique_ptr<BusEffect> createEffect(AvailableBusEffects p, Engine *e, BusEffectStorage *s);
+std::unique_ptr<BusEffect> createEffect(AvailableBusEffects p, BusEffectGlobals *g,
+                                        BusEffectStorage *s);
 
 struct Bus : MoveableOnly<Bus>, SampleRateSupport
 {
@@ -132,6 +144,13 @@ struct Bus : MoveableOnly<Bus>, SampleRateSupport
     Bus(BusAddress a) : address(a), downsampleFilter(6, true)
     {
         assert(address != DEFAULT_BUS && address != ERROR_BUS);
+        seedEffectRng();
+    }
+
+    // Seeded by address so a patch's effects are reproducible and no two busses share noise
+    void seedEffectRng()
+    {
+        effectGlobals.rng = sst::basic_blocks::dsp::RNG(0x5C0000u + (uint32_t)(address + 2));
     }
 
     void resetBus()
@@ -226,6 +245,7 @@ struct Bus : MoveableOnly<Bus>, SampleRateSupport
     std::array<BusEffectStorage, maxEffectsPerBus> busEffectStorage;
 
     std::array<std::unique_ptr<BusEffect>, maxEffectsPerBus> busEffects;
+    BusEffectGlobals effectGlobals;
 };
 
 inline std::string toStringAvailableBusEffects(const AvailableBusEffects &p)
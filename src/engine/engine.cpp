@@ -31,7 +31,9 @@
 #include "part.h"
 #include "sst/cpputils/iterators.h"
 #include "voice/voice.h"
+#include "render_pool.h"
 #include "dsp/data_tables.h"
+#include "dsp/sinc_kernels.h"
 #include "tuning/equal.h"
 #include "messaging/messaging.h"
 #include "messaging/audio/audio_messages.h"
@@ -51,6 +53,7 @@
 #include "SF.h"
 
 #include <version.h>
+#include <algorithm>
 #include <filesystem>
 #include <mutex>
 #include "messaging/client/client_serial.h"
@@ -68,6 +71,7 @@ Engine::Engine()
 
     messageController = std::make_unique<messaging::MessageController>(*this);
     dsp::sincTable.init();
+    dsp::sincKernels.init();
     dsp::dbTable.init();
     dsp::twoToTheXTable.init();
     tuning::equalTuning.init();
@@ -86,7 +90,38 @@ Engine::Engine()
                 SCLOG("Defaults Parse Error :" << em << " " << t << std::endl);
             });
 
+        sampleManager->streamingConfiguration.enabled = defaults->getUserDefaultValue(
+            infrastructure::DefaultKeys::streamLargeSamples, false);
+        sampleManager->mapSamplesWithoutCopy = defaults->getUserDefaultValue(
+            infrastructure::DefaultKeys::mapSamplesWithoutCopy, false);
+        sampleManager->precomputeDecimatedLevels = defaults->getUserDefaultValue(
+            infrastructure::DefaultKeys::precomputeDecimatedSamples, false);
+        sampleManager->compressResidentSamples = defaults->getUserDefaultValue(
+            infrastructure::DefaultKeys::compressSamplesInMemory, false);
+        audioRatePitchModulation = defaults->getUserDefaultValue(
+            infrastructure::DefaultKeys::audioRatePitchModulation, false);
+        // Off unless asked for, since it writes decoded copies of samples to disk
+        auto decodedCacheMB = defaults->getUserDefaultValue(
+            infrastructure::DefaultKeys::decodedSampleCacheSizeInMB, 0);
+        if (decodedCacheMB > 0)
+        {
+            sampleManager->decodedSampleCache = std::make_unique<sample::DecodedSampleCache>(
+                *tdp / "DecodedSampleCache", (uint64_t)decodedCacheMB << 20);
+        }
+        auto renderThreads =
+            defaults->getUserDefaultValue(infrastructure::DefaultKeys::renderThreads, 0);
+        if (renderThreads > 0)
+        {
+            renderPool = std::make_unique<RenderPool>(renderThreads);
+            parallelParts =
+                defaults->getUserDefaultValue(infrastructure::DefaultKeys::parallelParts, false);
+        }
+        sampleManager->onLoadProgress = [this](const auto &msg) {
+            messageController->updateClientActivityNotification(msg);
+        };
+
         browserDb = std::make_unique<browser::BrowserDB>(*tdp);
+        sampleManager->md5Cache = browserDb.get();
         browser = std::make_unique<browser::Browser>(
             *browserDb, *defaults, *tdp,
             [this](const auto &a, const auto &b) { messageController->reportErrorToClient(a, b); });
@@ -105,6 +140,14 @@ Engine::Engine()
     selectionManager = std::make_unique<selection::SelectionManager>(*this);
 
     memoryPool = std::make_unique<MemoryPool>();
+    // Backing for the zones' warm processor instances
+    memoryPool->preReservePool(dsp::processor::processorMemoryBufferSize);
+    // and the decode windows of voices playing compressed samples
+    if (sampleManager->compressResidentSamples)
+        memoryPool->preReservePool(sample::CompressedVoiceWindow::poolBlockBytes);
+    // and whatever the processors ask for, so the audio thread finds its classes full
+    dsp::processor::preReserveAllProcessorPools(memoryPool.get());
+    memoryPool->refill();
 
     voice::Voice::ahdsrenv_t::initializeLuts();
 
@@ -362,7 +405,7 @@ bool Engine::processAudio()
                 itm.group = v->zonePath.group;
                 itm.zone = v->zonePath.zone;
                 itm.sample = v->sampleIndex;
-                itm.samplePos = v->GD.samplePos;
+                itm.samplePos = v->GD.samplePos << v->decimatedLevel;
                 itm.midiNote = v->originalMidiKey;
                 itm.midiChannel = v->channel;
                 itm.gated = v->isGated;
@@ -378,6 +421,14 @@ bool Engine::processAudio()
     }
     lastUpdateVoiceDisplayState++;
 
+    if (memoryPool->takeRefillRequest())
+        messaging::audio::sendMemoryPoolRefill(*messageController);
+
+    requestZoneIndexRebuildIfStale();
+
+    if (compressedLoopSpansStale.exchange(false))
+        messaging::audio::sendCompressedLoopSpansStale(*messageController);
+
     auto processingEndTime = std::chrono::high_resolution_clock::now();
 
     auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(processingEndTime -
@@ -390,6 +441,127 @@ bool Engine::processAudio()
     return true;
 }
 
+void Engine::requestZoneIndexRebuildIfStale()
+{
+    if (zoneIndexRebuildPending)
+        return;
+
+    for (const auto &part : *patch)
+    {
+        if (!part->isZoneIndexCurrent())
+        {
+            zoneIndexRebuildPending = true;
+            messaging::audio::sendZoneIndexRebuild(*messageController);
+            return;
+        }
+    }
+}
+
+void Engine::rebuildZoneIndicesOnSerialThread()
+{
+    assert(messageController->threadingChecker.isSerialThread());
+
+    using indices_t = std::array<std::unique_ptr<Part::ZoneIndex>, numParts>;
+    auto built = std::make_shared<indices_t>();
+    for (const auto &[idx, part] : sst::cpputils::enumerate(*patch))
+    {
+        if (!part->isZoneIndexCurrent())
+            (*built)[idx] = part->buildZoneIndex();
+    }
+
+    // The audio thread swaps these in, leaving the old indices in built, which the
+    // completion then frees here. An index which went stale while we built it is
+    // rejected and the next block asks again.
+    messageController->scheduleAudioThreadCallback(
+        [built](auto &e) {
+            for (const auto &[idx, part] : sst::cpputils::enumerate(*(e.getPatch())))
+                part->publishZoneIndex((*built)[idx]);
+            e.zoneIndexRebuildPending = false;
+        },
+        [built](const auto &) {
+            for (auto &b : *built)
+                b.reset();
+        });
+}
+
+void Engine::updateCompressedLoopSpans()
+{
+    assert(messageController->threadingChecker.isSerialThread());
+
+    // The zone and retired list both hold one, so a count of one here means no voice does
+    retiredLoopSpans.erase(std::remove_if(retiredLoopSpans.begin(), retiredLoopSpans.end(),
+                                          [](const auto &s) { return s.use_count() == 1; }),
+                           retiredLoopSpans.end());
+
+    if (!sampleManager->compressResidentSamples)
+        return;
+
+    for (const auto &[pidx, part] : sst::cpputils::enumerate(*patch))
+    {
+        for (const auto &[gidx, group] : sst::cpputils::enumerate(*part))
+        {
+            for (const auto &[zidx, zone] : sst::cpputils::enumerate(*group))
+            {
+                for (int v = 0; v < Zone::maxVariantsPerZone; ++v)
+                {
+                    const auto &s = zone->samplePointers[v];
+                    const auto &vd = zone->variantData.variants[v];
+                    sample::DecodedSpan::Key want{};
+                    if (s && s->isCompressed() && vd.active && vd.loopActive)
+                        want = sample::DecodedSpan::loopSpanKey(*s, vd.startLoop, vd.endLoop,
+                                                                vd.loopFade);
+                    if (want == zone->compressedLoopSpanKeys[v])
+                        continue;
+                    zone->compressedLoopSpanKeys[v] = want;
+
+                    std::shared_ptr<sample::DecodedSpan> span;
+                    if (want.sample)
+                        span = sample::DecodedSpan::build(*s, want.start, want.end);
+
+                    // Swap on the audio thread, then retire whatever we swapped out here
+                    struct Swap
+                    {
+                        std::shared_ptr<sample::DecodedSpan> span;
+                        bool swapped{false};
+                    };
+                    auto holder = std::make_shared<Swap>();
+                    holder->span = std::move(span);
+                    messageController->scheduleAudioThreadCallback(
+                        [holder, p = pidx, g = gidx, z = zidx, id = zone->id, v](auto &e) {
+                            const auto &pt = e.getPatch()->getPart(p);
+                            if (g >= pt->getGroups().size())
+                                return;
+                            const auto &gr = pt->getGroup(g);
+                            if (z >= gr->getZones().size() || gr->getZone((int)z)->id != id)
+                                return;
+                            std::swap(gr->getZone((int)z)->compressedLoopSpans[v], holder->span);
+                            holder->swapped = true;
+                        },
+                        [this, holder, id = zone->id, v](auto &) {
+                            // If the zone moved before we got there, ask again next block
+                            if (!holder->swapped)
+                            {
+                                forgetCompressedLoopSpanKey(id, v);
+                                compressedLoopSpansStale = true;
+                            }
+                            if (holder->span)
+                                retiredLoopSpans.push_back(std::move(holder->span));
+                        });
+                }
+            }
+        }
+    }
+}
+
+void Engine::forgetCompressedLoopSpanKey(const ZoneID &id, int variant)
+{
+    for (const auto &part : *patch)
+        for (const auto &group : *part)
+            for (const auto &zone : *group)
+                if (zone->id == id)
+                    zone->compressedLoopSpanKeys[variant] = {};
+}
+
 void Engine::assertActiveVoiceCount()
 {
     uint32_t res{0};
@@ -684,7 +856,7 @@ void Engine::loadSf2MultiSampleIntoSelectedPart(const fs::path &p)
     {
         auto riff = std::make_unique<RIFF::File>(p.u8string());
         auto sf = std::make_unique<sf2::File>(riff.get());
-        auto md5 = infrastructure::createMD5SumFromFile(p);
+        auto md5 = infrastructure::createMD5SumFromFile(p, browserDb.get());
 
         auto pt = getSelectionManager()->selectedPart;
 
@@ -41,6 +41,7 @@
 #include "sample/sample.h"
 #include "sample/sample_manager.h"
 
+#include <atomic>
 #include <filesystem>
 #include <memory>
 #include <set>
@@ -78,6 +79,8 @@ struct BrowserDB;
 
 namespace scxt::engine
 {
+struct RenderPool;
+
 struct Engine : MoveableOnly<Engine>, SampleRateSupport
 {
     Engine();
@@ -114,12 +117,14 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     void updateTransportPhasors();
 
     /**
-     * Midi-style events. Each event is assumed to be at the top of the
-     * blockSize sample block
+     * Midi-style events. Each event is applied at the top of the blockSize sample
+     * block, but a wrapper which dispatches a block's events before calling
+     * processAudio can set eventSampleOffset to where in that block the event lands.
+     * Voices started by the event then begin at that sample rather than the block
+     * top. Releases and parameter changes still apply for the whole block.
      */
+    int16_t eventSampleOffset{0};
 
-    // TODO: This is obviusly a pretty inefficient search method. We can definitel
-    // pre-cache some of this lookup when the patch mutates
     struct pathToZone_t
     {
         size_t part{0};
@@ -140,12 +145,23 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
                 (part->configuration.channel == channel ||
                  part->configuration.channel == Part::PartConfiguration::omniChannel))
             {
+                const Part::ZoneIndexEntry *ib, *ie;
+                if (part->zoneIndexCandidates(key, velocity, ib, ie))
+                {
+                    for (auto it = ib; it != ie && idx < res.size(); ++it)
+                    {
+                        res[idx] = {(size_t)pidx, it->group, it->zone, channel, key, noteId};
+                        idx++;
+                    }
+                    continue;
+                }
+
                 for (const auto &[gidx, group] : sst::cpputils::enumerate(*part))
                 {
                     for (const auto &[zidx, zone] : sst::cpputils::enumerate(*group))
                     {
                         if (zone->mapping.keyboardRange.includes(key) &&
-                            zone->mapping.velocityRange.includes(velocity))
+                            zone->mapping.velocityRange.includes(velocity) && idx < res.size())
                         {
                             res[idx] = {(size_t)pidx, (size_t)gidx, (size_t)zidx,
                                         channel,      key,          noteId};
@@ -158,6 +174,28 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
         return idx;
     }
 
+    /*
+     * Zone indices go stale when a structure or mapping change bumps a part's index
+     * generation. Once per block the audio thread asks the serialization thread for
+     * a rebuild if any are stale; that thread builds them and sends them back to be
+     * swapped in, and the previous indices are freed back on the serialization thread.
+     */
+    void requestZoneIndexRebuildIfStale();
+    void rebuildZoneIndicesOnSerialThread();
+    bool zoneIndexRebuildPending{false};
+
+    /*
+     * Looped variants of compressed samples read their loop from a DecodedSpan their
+     * zone holds. Zone structure, sample and loop changes mark them stale, the audio
+     * thread passes that on once per block, and we bring them up to date on the
+     * serialization thread. Replaced spans are parked in retiredLoopSpans until
+     * no voice holds them any more, so the audio thread never frees one.
+     */
+    std::atomic<bool> compressedLoopSpansStale{true};
+    void updateCompressedLoopSpans();
+    void forgetCompressedLoopSpanKey(const ZoneID &id, int variant);
+    std::vector<std::shared_ptr<sample::DecodedSpan>> retiredLoopSpans;
+
     tuning::MidikeyRetuner midikeyRetuner;
 
     // new voice manager style
@@ -171,6 +209,17 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
         Engine &engine;
         std::array<pathToZone_t, maxVoices> findZoneWorkingBuffer;
 
+        // The voice manager asks for a count then initializes the same note, so we
+        // keep the first lookup in findZoneWorkingBuffer and reuse it
+        struct FindZoneCache
+        {
+            bool valid{false};
+            int16_t channel{-1}, key{-1}, velocity{-1};
+            int32_t noteId{-1};
+            size_t count{0};
+        } findZoneCache;
+        size_t findZoneCached(int16_t channel, int16_t key, int32_t noteId, int16_t velocity);
+
         VoiceManagerResponder(Engine &e) : engine(e) {}
 
         std::function<void(voice::Voice *)> voiceEndCallback{nullptr};
@@ -331,6 +380,9 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
 
         std::atomic<float> cpuLevel{0};
         std::atomic<float> ramUsage{0};
+
+        // Blocks where a disk streamed voice had no data resident and played silence
+        std::atomic<uint32_t> streamingUnderruns{0};
     } sharedUIMemoryState;
 
     /* When we actually unstream an entire engine we want to know if we are doing
@@ -391,6 +443,21 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
      */
     sst::basic_blocks::dsp::RNG rng;
 
+    /*
+     * If configured (the renderThreads default) we spread rendering across this pool
+     * of workers. Null means render on the audio thread only. With parallelParts set,
+     * a block with several independent active parts renders the parts concurrently;
+     * otherwise each part renders its voices concurrently.
+     */
+    std::unique_ptr<RenderPool> renderPool;
+    bool parallelParts{false};
+    // Set by the patch on the audio thread while its parts are on the render pool
+    bool partsRenderingInParallel{false};
+    // Shared by every zone's WarmProcessorPool
+    dsp::processor::WarmProcessorBudget warmProcessorBudget;
+    // Ramp modulated pitch through the block (the audioRatePitchModulation default)
+    bool audioRatePitchModulation{false};
+
     /*
      * Serialization thread originated mutation apis
      */
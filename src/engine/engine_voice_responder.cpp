@@ -30,13 +30,31 @@
 
 namespace scxt::engine
 {
+size_t Engine::VoiceManagerResponder::findZoneCached(int16_t channel, int16_t key, int32_t noteId,
+                                                     int16_t velocity)
+{
+    auto &c = findZoneCache;
+    if (c.valid && c.channel == channel && c.key == key && c.noteId == noteId &&
+        c.velocity == velocity)
+    {
+        return c.count;
+    }
+
+    c.count = engine.findZone(channel, key, noteId, velocity, findZoneWorkingBuffer);
+    c.channel = channel;
+    c.key = key;
+    c.noteId = noteId;
+    c.velocity = velocity;
+    c.valid = true;
+    return c.count;
+}
+
 int32_t Engine::VoiceManagerResponder::voiceCountForInitializationAction(
     uint16_t port, uint16_t channel, uint16_t key, int32_t noteId, float velocity)
 {
-    // TODO: We can optimize this so we don't have to find twice in the future
     auto useKey = engine.midikeyRetuner.remapKeyTo(channel, key);
-    auto nts = engine.findZone(channel, useKey, noteId, std::clamp((int)(velocity * 128), 0, 127),
-                               findZoneWorkingBuffer);
+    findZoneCache.valid = false;
+    auto nts = findZoneCached(channel, useKey, noteId, std::clamp((int)(velocity * 128), 0, 127));
 
     return nts;
 }
@@ -46,8 +64,9 @@ int32_t Engine::VoiceManagerResponder::initializeMultipleVoices(
     uint16_t channel, uint16_t key, int32_t noteId, float velocity, float retune)
 {
     auto useKey = engine.midikeyRetuner.remapKeyTo(channel, key);
-    auto nts = engine.findZone(channel, useKey, noteId, std::clamp((int)(velocity * 128), 0, 127),
-                               findZoneWorkingBuffer);
+    auto nts = findZoneCached(channel, useKey, noteId, std::clamp((int)(velocity * 128), 0, 127));
+    // Voice initialization can change zone state so never reuse this for a later note
+    findZoneCache.valid = false;
 
     for (auto idx = 0; idx < nts; ++idx)
     {
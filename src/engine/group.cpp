@@ -334,6 +334,14 @@ void Group::removeActiveZone()
     }
 }
 
+void Group::onZoneStructureChanged()
+{
+    if (parentPart)
+        parentPart->invalidateZoneIndex();
+    if (auto e = getEngine())
+        e->compressedLoopSpansStale = true;
+}
+
 engine::Engine *Group::getEngine()
 {
     if (parentPart && parentPart->parentPatch)
@@ -105,6 +105,7 @@ struct Group : MoveableOnly<Group>,
     {
         z->parentGroup = this;
         zones.push_back(std::move(z));
+        onZoneStructureChanged();
         return zones.size();
     }
 
@@ -112,10 +113,18 @@ struct Group : MoveableOnly<Group>,
     {
         z->parentGroup = this;
         zones.push_back(std::move(z));
+        onZoneStructureChanged();
         return zones.size();
     }
 
-    void clearZones() { zones.clear(); }
+    void clearZones()
+    {
+        zones.clear();
+        onZoneStructureChanged();
+    }
+
+    // Invalidates our part's note-on zone index
+    void onZoneStructureChanged();
 
     int getZoneIndex(const ZoneID &zid) const
     {
@@ -149,12 +158,14 @@ struct Group : MoveableOnly<Group>,
         auto res = std::move(zones[idx]);
         zones.erase(zones.begin() + idx);
         res->parentGroup = nullptr;
+        onZoneStructureChanged();
         return res;
     }
 
     void swapZonesByIndex(size_t zoneIndex0, size_t zoneIndex1)
     {
         std::swap(zones[zoneIndex0], zones[zoneIndex1]);
+        onZoneStructureChanged();
     }
 
     bool isActive() const;
@@ -30,107 +30,191 @@
 
 namespace scxt::engine
 {
-/*
- * A massive TODO here. Right now this allocates on the audio thread but we
- * can instead have this have a message contrller refecence at construction time
- * and instead try to ask the audio thread to allocate.
- */
-
 MemoryPool::~MemoryPool()
 {
     assert(debugCheckouts == debugReturns);
 
-    for (auto &[sz, s] : cache)
+    for (auto &c : classes)
     {
-        while (!s.empty())
+        for (auto &sl : c.slots)
         {
-            delete[] s.front();
-            s.pop();
+            delete[] sl.load();
         }
     }
 }
 
-#define ALLOCATE_IMPLEMENTATION 0
-#if ALLOCATE_IMPLEMENTATION
-void MemoryPool::preReservePool(size_t blockSize) {}
-MemoryPool::data_t *MemoryPool::checkoutBlock(size_t blockSize)
+MemoryPool::SizeClass *MemoryPool::findClass(size_t blockSize)
 {
-    // Technically don't need this in the naive impl but lets avoid some bugs
-    debugCheckouts++;
-    auto ubs = nearestBlock(blockSize);
-    return new data_t[ubs];
+    for (auto &c : classes)
+    {
+        auto bs = c.blockSize.load(std::memory_order_acquire);
+        if (bs == blockSize)
+            return &c;
+        if (bs == 0)
+            return nullptr;
+    }
+    return nullptr;
 }
-void MemoryPool::returnBlock(data_t *block, size_t blockSize)
+
+MemoryPool::SizeClass *MemoryPool::findOrClaimClass(size_t blockSize, bool &claimed)
 {
-    debugReturns++;
-    delete[] block;
+    claimed = false;
+    for (auto &c : classes)
+    {
+        size_t expected{0};
+        if (c.blockSize.compare_exchange_strong(expected, blockSize, std::memory_order_acq_rel))
+        {
+            claimed = true;
+            return &c;
+        }
+        if (expected == blockSize)
+            return &c;
+    }
+    SCLOG_ONCE("Memory pool is out of size classes. Raise maxSizeClasses");
+    return nullptr;
 }
-#else
 
-static constexpr size_t initialPoolSize{16};
-MemoryPool::data_t *MemoryPool::checkoutBlock(size_t requestBlockSize)
+MemoryPool::data_t *MemoryPool::take(SizeClass &c)
 {
-    // Technically don't need this in the naive impl but lets avoid some bugs
-    auto blockSize = nearestBlock(requestBlockSize);
-    auto cacheP = cache.find(blockSize);
-    assert(cacheP != cache.end()); // If you hit this you didn't pre-reserve
-    if (cacheP == cache.end())
+    for (auto &sl : c.slots)
     {
-        return nullptr;
+        if (!sl.load(std::memory_order_relaxed))
+            continue;
+        if (auto *res = sl.exchange(nullptr, std::memory_order_acquire))
+        {
+            c.available.fetch_sub(1, std::memory_order_relaxed);
+            return res;
+        }
     }
-    if (cacheP->second.empty())
+    return nullptr;
+}
+
+bool MemoryPool::put(SizeClass &c, data_t *block)
+{
+    for (auto &sl : c.slots)
     {
-        growBlock(requestBlockSize, initialPoolSize);
-        return checkoutBlock(requestBlockSize);
+        data_t *expected{nullptr};
+        if (sl.load(std::memory_order_relaxed))
+            continue;
+        if (sl.compare_exchange_strong(expected, block, std::memory_order_release))
+        {
+            c.available.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
     }
+    return false;
+}
 
-    debugCheckouts++;
-    auto res = cacheP->second.front();
-    cacheP->second.pop();
+void MemoryPool::fill(SizeClass &c, int32_t to)
+{
+    auto bs = c.blockSize.load(std::memory_order_acquire);
+    while (c.available.load(std::memory_order_relaxed) < to)
+    {
+        auto *block = new data_t[bs];
+        if (!put(c, block))
+        {
+            delete[] block;
+            break;
+        }
+    }
+}
 
-    // Please leave these in. Handy to debug
-    // SCLOG(blockSize << " : Post checkout size is " << cacheP->second.size());
-    return res;
+MemoryPool::data_t *MemoryPool::borrowLarger(size_t blockSize)
+{
+    // Larger blocks are just as good. They go back to the smaller class when returned,
+    // which only ever gives it more room than it needs, and delete[] doesn't care
+    SizeClass *best{nullptr};
+    for (auto &c : classes)
+    {
+        auto bs = c.blockSize.load(std::memory_order_acquire);
+        if (bs == 0)
+            break;
+        if (bs > blockSize && c.available.load(std::memory_order_relaxed) > 0 &&
+            (!best || bs < best->blockSize.load(std::memory_order_relaxed)))
+            best = &c;
+    }
+    return best ? take(*best) : nullptr;
 }
-void MemoryPool::returnBlock(data_t *block, size_t requestBlockSize)
+
+MemoryPool::data_t *MemoryPool::checkoutBlock(size_t requestBlockSize)
 {
-    debugReturns++;
     auto blockSize = nearestBlock(requestBlockSize);
-    auto cacheP = cache.find(blockSize);
-    assert(cacheP != cache.end()); // If you hit this you didn't pre-reserve
+    auto *c = findClass(blockSize);
+    assert(c); // If you hit this you didn't pre-reserve
 
-    cacheP->second.push(block);
+    debugCheckouts++;
+    if (c)
+    {
+        c->checkouts.fetch_add(1, std::memory_order_relaxed);
+        auto *res = take(*c);
+        if (c->available.load(std::memory_order_relaxed) < lowWatermark)
+            refillRequested.store(true, std::memory_order_release);
+        if (res)
+            return res;
+        c->misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (auto *res = borrowLarger(blockSize))
+        return res;
 
-    // SCLOG(blockSize << ": Post return size is " << cacheP->second.size());
+    // Every class we could use is empty, so this allocation lands on the calling thread
+    return new data_t[blockSize];
 }
 
-void MemoryPool::growBlock(size_t requestBlockSize, size_t byEntries)
+void MemoryPool::returnBlock(data_t *block, size_t requestBlockSize)
 {
+    debugReturns++;
     auto blockSize = nearestBlock(requestBlockSize);
-    // SCLOG(blockSize << ": Growing pool " << blockSize);
-    auto cacheP = cache.find(blockSize);
-    assert(cacheP != cache.end()); // If you hit this you didn't pre-reserve
+    auto *c = findClass(blockSize);
+    assert(c); // If you hit this you didn't pre-reserve
 
-    for (auto i = 0U; i < initialPoolSize; ++i)
-    {
-        cacheP->second.push(new data_t[blockSize]);
-    }
-    // SCLOG(blockSize << ": Post grow size is " << cacheP->second.size());
+    if (c && put(*c, block))
+        return;
+    if (c)
+        c->overflows.fetch_add(1, std::memory_order_relaxed);
+    delete[] block;
 }
 
 void MemoryPool::preReservePool(size_t requestBlockSize)
 {
     auto blockSize = nearestBlock(requestBlockSize);
-    auto cacheP = cache.find(blockSize);
-    if (cacheP == cache.end())
+    bool claimed;
+    findOrClaimClass(blockSize, claimed);
+    // This may be the audio thread, so leave the filling to the next refill
+    if (claimed)
+        refillRequested.store(true, std::memory_order_release);
+}
+
+void MemoryPool::refill()
+{
+    for (auto &c : classes)
     {
-        auto cacheSet = pool_t();
+        if (c.blockSize.load(std::memory_order_acquire) == 0)
+            break;
+        fill(c, highWatermark);
 
-        cache.insert({blockSize, cacheSet});
-        growBlock(requestBlockSize, initialPoolSize);
+        auto m = c.misses.load(std::memory_order_relaxed);
+        if (m != c.missesAtLastRefill)
+        {
+            SCLOG("Memory pool class " << c.blockSize << " missed " << (m - c.missesAtLastRefill)
+                                       << " checkouts; consider a larger highWatermark");
+            c.missesAtLastRefill = m;
+        }
     }
-    // SCLOG(blockSize << ": Pre-Reserve cache found " << cache.at(blockSize).size() << " entries")
 }
-#endif
 
-} // namespace scxt::engine
\ No newline at end of file
+MemoryPool::Stats MemoryPool::getStats() const
+{
+    Stats res;
+    for (auto &c : classes)
+    {
+        if (c.blockSize.load(std::memory_order_acquire) == 0)
+            break;
+        res.sizeClasses++;
+        res.checkouts += c.checkouts.load(std::memory_order_relaxed);
+        res.misses += c.misses.load(std::memory_order_relaxed);
+        res.overflows += c.overflows.load(std::memory_order_relaxed);
+    }
+    return res;
+}
+} // namespace scxt::engine
@@ -28,38 +28,93 @@
 #ifndef SCXT_SRC_ENGINE_MEMORY_POOL_H
 #define SCXT_SRC_ENGINE_MEMORY_POOL_H
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <cctype>
-#include <unordered_map>
-#include <unordered_set>
-#include <queue>
 
 #include "utils.h"
 
 namespace scxt::engine
 {
+/*
+ * A pool of memory blocks for processors, which check them out as they are spawned on
+ * the audio thread. Blocks are bucketed into size classes (the request rounded up to
+ * the next KB) held in a fixed table, and each class keeps its free blocks in a fixed
+ * array of atomic slots, so checkout and return never lock or allocate and may be called
+ * from any thread.
+ *
+ * When a class falls below lowWatermark, or is first claimed, a refill is requested. The
+ * audio thread picks that up at the end of the block and sends it to the serialization
+ * thread, which tops every class back up to highWatermark. The engine registers and fills
+ * the classes of every processor it knows about at startup, so claims from the audio
+ * thread should find their class already there. A checkout from an empty class is a
+ * miss: it borrows a block from the next larger class which has one, and only if every
+ * larger class is empty too does it allocate on the calling thread. The stats are there
+ * so the watermarks can be sized to keep misses at zero.
+ */
 struct MemoryPool : MoveableOnly<MemoryPool>
 {
     typedef uint8_t data_t;
 
+    static constexpr size_t maxSizeClasses{32};
+    static constexpr size_t slotsPerClass{128};
+    static constexpr int32_t lowWatermark{8}, highWatermark{32};
+
     ~MemoryPool();
 
+    // Registers the size class, asking for a refill if it is new. Never allocates
     void preReservePool(size_t blockSize);
 
     data_t *checkoutBlock(size_t blockSize);
     void returnBlock(data_t *block, size_t blockSize);
 
+    // Audio thread, once per block. True (once) if a refill should be sent off
+    bool takeRefillRequest()
+    {
+        return refillRequested.load(std::memory_order_relaxed) &&
+               refillRequested.exchange(false, std::memory_order_acq_rel);
+    }
+    // Serialization thread
+    void refill();
+
+    struct Stats
+    {
+        uint64_t checkouts{0};
+        uint64_t misses{0};    // checkouts which had to allocate
+        uint64_t overflows{0}; // returns with no free slot, which had to free
+        size_t sizeClasses{0};
+    };
+    Stats getStats() const;
+
   private:
     template <size_t N = 10> static inline size_t nearestBlock(size_t x)
     {
         return ((x >> N) + 1) * (1 << N);
     }
-    void growBlock(size_t blockSize, size_t byEntries);
-    using pool_t = std::queue<data_t *>;
-    using cache_t = std::unordered_map<size_t, pool_t>;
-    cache_t cache;
 
-    int64_t debugCheckouts{0}, debugReturns{0};
+    struct SizeClass
+    {
+        std::atomic<size_t> blockSize{0}; // 0 is an unclaimed class
+        std::array<std::atomic<data_t *>, slotsPerClass> slots{};
+        std::atomic<int32_t> available{0};
+        std::atomic<uint64_t> checkouts{0}, misses{0}, overflows{0};
+        uint64_t missesAtLastRefill{0}; // serialization thread only
+    };
+
+    // Classes are claimed in table order and never released, so a lookup can stop at the
+    // first unclaimed one
+    SizeClass *findClass(size_t blockSize);
+    SizeClass *findOrClaimClass(size_t blockSize, bool &claimed);
+    data_t *take(SizeClass &c);
+    data_t *borrowLarger(size_t blockSize);
+    bool put(SizeClass &c, data_t *block);
+    void fill(SizeClass &c, int32_t to);
+
+    std::array<SizeClass, maxSizeClasses> classes;
+    std::atomic<bool> refillRequested{false};
+
+    std::atomic<int64_t> debugCheckouts{0}, debugReturns{0};
 };
 } // namespace scxt::engine
 
@@ -25,10 +25,14 @@
  * https://github.com/surge-synthesizer/shortcircuit-xt
  */
 
+#include <limits>
+
 #include "part.h"
 #include "bus.h"
 #include "patch.h"
 #include "engine.h"
+#include "voice/voice.h"
+#include "render_pool.h"
 
 #include "selection/selection_manager.h"
 
@@ -46,6 +50,10 @@ void Part::process(Engine &e)
             sm.step();
     pitchBendSmoother.step();
 
+    // Batches don't nest, so if the parts are on the pool we render our voices here
+    if (e.renderPool && !e.partsRenderingInParallel)
+        renderVoicesAhead(e);
+
     for (const auto &g : groups)
     {
         if (g->isActive())
@@ -66,6 +74,153 @@ void Part::process(Engine &e)
     }
 }
 
+std::unique_ptr<Part::ZoneIndex> Part::buildZoneIndex() const
+{
+    // Read first so a change made while we walk leaves this index stale on arrival
+    auto res = std::make_unique<ZoneIndex>();
+    res->generation = zoneIndexGeneration.load();
+
+    static constexpr int16_t mx{(int16_t)zoneIndexDimension - 1};
+    auto clampedRanges = [](const auto &z) {
+        const auto &kr = z->mapping.keyboardRange;
+        const auto &vr = z->mapping.velocityRange;
+        return std::array<int16_t, 4>{std::max(kr.keyStart, (int16_t)0),
+                                      std::min(kr.keyEnd, mx),
+                                      std::max(vr.velStart, (int16_t)0),
+                                      std::min(vr.velEnd, mx)};
+    };
+
+    // Size it first so a pathological patch doesn't cost us a huge index
+    size_t total{0};
+    if (groups.size() > std::numeric_limits<uint16_t>::max())
+        return res;
+    for (const auto &g : groups)
+    {
+        if (g->getZones().size() > std::numeric_limits<uint16_t>::max())
+            return res;
+        for (const auto &z : *g)
+        {
+            auto [ks, ke, vs, ve] = clampedRanges(z);
+            if (ks <= ke && vs <= ve)
+                total += (size_t)(ke - ks + 1) * (ve - vs + 1);
+        }
+    }
+    if (total > maxZoneIndexEntries)
+    {
+        SCLOG_ONCE("Part zone index would have " << total << " entries; using a zone walk");
+        return res;
+    }
+
+    static constexpr size_t nBuckets{zoneIndexDimension * zoneIndexDimension};
+    auto &offsets = res->offsets;
+    offsets.assign(nBuckets + 1, 0);
+    for (const auto &g : groups)
+    {
+        for (const auto &z : *g)
+        {
+            auto [ks, ke, vs, ve] = clampedRanges(z);
+            for (auto k = ks; k <= ke; ++k)
+                for (auto v = vs; v <= ve; ++v)
+                    offsets[k * zoneIndexDimension + v + 1]++;
+        }
+    }
+    for (size_t b = 0; b < nBuckets; ++b)
+        offsets[b + 1] += offsets[b];
+
+    res->entries.resize(total);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (const auto &[gidx, g] : sst::cpputils::enumerate(groups))
+    {
+        for (const auto &[zidx, z] : sst::cpputils::enumerate(*g))
+        {
+            auto [ks, ke, vs, ve] = clampedRanges(z);
+            for (auto k = ks; k <= ke; ++k)
+                for (auto v = vs; v <= ve; ++v)
+                    res->entries[fill[k * zoneIndexDimension + v]++] = {(uint16_t)gidx,
+                                                                         (uint16_t)zidx};
+        }
+    }
+    return res;
+}
+
+bool Part::publishZoneIndex(std::unique_ptr<ZoneIndex> &idx)
+{
+    if (!idx || idx->generation != zoneIndexGeneration)
+        return false;
+    std::swap(zoneIndex, idx);
+    return true;
+}
+
+bool Part::canProcessInParallel() const
+{
+    for (const auto &g : groups)
+    {
+        if (!g->isActive())
+            continue;
+        auto gr = g->outputInfo.routeTo;
+        if (gr != DEFAULT_BUS && gr != (BusAddress)(PART_0 + partNumber))
+            return false;
+        for (const auto &z : *g)
+        {
+            if (!z->isActive())
+                continue;
+            if (z->outputInfo.routeTo != DEFAULT_BUS)
+                return false;
+            for (const auto *v : z->voiceWeakPointers)
+                if (v && v->isVoiceAssigned && v->streamSlot)
+                    return false;
+        }
+    }
+    return true;
+}
+
+void Part::runDeferredVoiceCleanup()
+{
+    for (size_t i = 0; i < deferredCleanupCount; ++i)
+    {
+#if DEBUG_VOICE_LIFECYCLE
+        SCLOG("Deferred Cleanup Voice at " << SCDBGV((int)deferredCleanup[i]->key));
+#endif
+        deferredCleanup[i]->cleanupVoice();
+    }
+    deferredCleanupCount = 0;
+}
+
+void Part::renderVoicesAhead(Engine &e)
+{
+    auto &pool = *e.renderPool;
+    pool.beginBatch([](void *item) {
+        auto v = static_cast<voice::Voice *>(item);
+        v->renderedAheadResult = v->process();
+    });
+
+    // The same walk process does, so voices see exactly the state they would have
+    for (const auto &g : groups)
+    {
+        if (!g->isActive())
+            continue;
+        for (const auto &z : *g)
+        {
+            if (!z->isActive())
+                continue;
+
+            // Zone process runs this before voices so we have to run it first
+            z->mUILag.process();
+            z->processSharedLFOs();
+            z->voicesRenderedAhead = true;
+            for (auto *v : z->voiceWeakPointers)
+            {
+                // Streamed voices share an SPSC request queue so stay on this thread
+                if (v && v->isVoiceAssigned && !v->streamSlot)
+                {
+                    v->renderedAhead = pool.add(v);
+                }
+            }
+        }
+    }
+    pool.render();
+}
+
 Part::zoneMappingSummary_t Part::getZoneMappingSummary()
 {
     zoneMappingSummary_t res;
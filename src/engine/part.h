@@ -27,6 +27,7 @@
 #ifndef SCXT_SRC_ENGINE_PART_H
 #define SCXT_SRC_ENGINE_PART_H
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <optional>
@@ -78,6 +79,22 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
         BusAddress routeTo{DEFAULT_BUS};
     } configuration;
     void process(Engine &onto);
+    void renderVoicesAhead(Engine &onto);
+
+    /*
+     * A part may render concurrently with other parts if everything it plays lands on
+     * its own part bus and none of its voices stream. Voices which finish while parts
+     * render concurrently are queued here and cleaned up on the audio thread after.
+     */
+    bool canProcessInParallel() const;
+    void deferVoiceCleanup(voice::Voice *v)
+    {
+        assert(deferredCleanupCount < deferredCleanup.size());
+        deferredCleanup[deferredCleanupCount++] = v;
+    }
+    void runDeferredVoiceCleanup();
+    std::array<voice::Voice *, maxVoices> deferredCleanup{};
+    size_t deferredCleanupCount{0};
 
     // TODO: editable name
     std::string getName() const
@@ -118,6 +135,7 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
         g->name = cn;
 
         groups.push_back(std::move(g));
+        invalidateZoneIndex();
         return groups.size();
     }
 
@@ -174,7 +192,11 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
     typedef std::vector<std::unique_ptr<Group>> groupContainer_t;
 
     const groupContainer_t &getGroups() const { return groups; }
-    void clearGroups() { groups.clear(); }
+    void clearGroups()
+    {
+        groups.clear();
+        invalidateZoneIndex();
+    }
     int getGroupIndex(const GroupID &zid) const
     {
         for (const auto &[idx, r] : sst::cpputils::enumerate(groups))
@@ -191,6 +213,7 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
         auto res = std::move(groups[idx]);
         groups.erase(groups.begin() + idx);
         res->parentPart = nullptr;
+        invalidateZoneIndex();
         return res;
     }
     groupContainer_t::iterator begin() noexcept { return groups.begin(); }
@@ -199,8 +222,61 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
     groupContainer_t::iterator end() noexcept { return groups.end(); }
     groupContainer_t::const_iterator cend() const noexcept { return groups.cend(); }
 
+    /*
+     * Note-on lookup. Rather than test every zone on each note we keep a 128x128 key by
+     * velocity bucket index of the zones in this part, in group then zone order so
+     * results match a full walk. Structure and mapping changes bump a generation on
+     * the thread which makes them. The index is built on the serialization thread with
+     * buildZoneIndex and handed to the audio thread which swaps it in with
+     * publishZoneIndex, so the audio thread never builds or frees one. Until an index
+     * for the current generation arrives, or if it would be unreasonably large, or if
+     * a lookup is outside 0-127, callers fall back to walking the zones.
+     */
+    struct ZoneIndexEntry
+    {
+        uint16_t group, zone;
+    };
+    static constexpr size_t zoneIndexDimension{128};
+    static constexpr size_t maxZoneIndexEntries{1 << 20};
+
+    struct ZoneIndex
+    {
+        uint32_t generation{0};
+        std::vector<uint32_t> offsets;
+        std::vector<ZoneIndexEntry> entries;
+    };
+
+    void invalidateZoneIndex() { zoneIndexGeneration++; }
+    bool isZoneIndexCurrent() const
+    {
+        return zoneIndex && zoneIndex->generation == zoneIndexGeneration;
+    }
+    // An index too large to be worth having comes back empty, which means walk
+    std::unique_ptr<ZoneIndex> buildZoneIndex() const;
+    // Swaps in a built index if nothing changed since it was built, leaving the
+    // previous index (or the rejected one) in idx for the caller to free
+    bool publishZoneIndex(std::unique_ptr<ZoneIndex> &idx);
+
+    bool zoneIndexCandidates(int16_t key, int16_t velocity, const ZoneIndexEntry *&begin,
+                             const ZoneIndexEntry *&end) const
+    {
+        if (!isZoneIndexCurrent() || zoneIndex->offsets.empty())
+            return false;
+        if (key < 0 || key >= (int16_t)zoneIndexDimension || velocity < 0 ||
+            velocity >= (int16_t)zoneIndexDimension)
+            return false;
+
+        auto b = key * zoneIndexDimension + velocity;
+        begin = zoneIndex->entries.data() + zoneIndex->offsets[b];
+        end = zoneIndex->entries.data() + zoneIndex->offsets[b + 1];
+        return true;
+    }
+
   private:
     groupContainer_t groups;
+
+    std::atomic<uint32_t> zoneIndexGeneration{1};
+    std::unique_ptr<ZoneIndex> zoneIndex;
 };
 } // namespace scxt::engine
 
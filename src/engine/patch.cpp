@@ -26,6 +26,8 @@
  */
 
 #include "patch.h"
+#include "engine.h"
+#include "render_pool.h"
 #include "sst/basic-blocks/mechanics/block-ops.h"
 
 namespace scxt::engine
@@ -41,18 +43,27 @@ void Patch::process(Engine &e)
     for (auto &b : busses.auxBusses)
         b.clear();
 
-    // Run each of the parts, accumulating onto the engine busses
-    for (const auto &part : parts)
+    if (e.renderPool && e.parallelParts)
+    {
+        processPartsInParallel(e);
+    }
+    else
     {
-        if (part->isActive())
+        // Run each of the parts, accumulating onto the engine busses
+        for (const auto &part : parts)
         {
-            part->process(e);
+            if (part->isActive())
+            {
+                part->process(e);
+            }
         }
+
+        for (auto &b : busses.partBusses)
+            b.process();
     }
 
     for (auto &b : busses.partBusses)
     {
-        b.process();
         if (b.busSendStorage.supportsSends && b.busSendStorage.hasSends)
         {
             for (int i = 0; i < numAux; ++i)
@@ -135,6 +146,58 @@ void Patch::process(Engine &e)
     busses.mainBus.process();
 }
 
+void Patch::processPartsInParallel(Engine &e)
+{
+    auto &pool = *e.renderPool;
+
+    /*
+     * Parts which only write their own part bus go on the pool together; anything
+     * routing elsewhere (or streaming) runs on this thread, in order, after them.
+     * There's no point paying for the pool for a single part though.
+     */
+    std::array<Part *, numParts> parallelParts{}, serialParts{};
+    size_t parallelCount{0}, serialCount{0};
+    for (const auto &part : parts)
+    {
+        if (!part->isActive())
+            continue;
+        if (part->canProcessInParallel())
+            parallelParts[parallelCount++] = part.get();
+        else
+            serialParts[serialCount++] = part.get();
+    }
+
+    if (parallelCount > 1)
+    {
+        pool.beginBatch([](void *item) {
+            auto p = static_cast<Part *>(item);
+            p->process(*p->parentPatch->parentEngine);
+        });
+        for (size_t i = 0; i < parallelCount; ++i)
+            pool.add(parallelParts[i]);
+
+        e.partsRenderingInParallel = true;
+        pool.render();
+        e.partsRenderingInParallel = false;
+
+        for (size_t i = 0; i < parallelCount; ++i)
+            parallelParts[i]->runDeferredVoiceCleanup();
+    }
+    else if (parallelCount == 1)
+    {
+        parallelParts[0]->process(e);
+    }
+
+    for (size_t i = 0; i < serialCount; ++i)
+        serialParts[i]->process(e);
+
+    // Every part has now written its bus, so the bus effect chains are independent too
+    pool.beginBatch([](void *item) { static_cast<Bus *>(item)->process(); });
+    for (auto &b : busses.partBusses)
+        pool.add(&b);
+    pool.render();
+}
+
 void Patch::setupBussesOnUnstream(Engine &e)
 {
     // Assume the bus storage is correct
@@ -54,6 +54,7 @@ struct Patch : MoveableOnly<Patch>, SampleRateSupport
             {
                 p.resetBus();
                 p.address = (BusAddress)adr;
+                p.seedEffectRng();
                 p.busSendStorage.supportsSends = true;
                 adr++;
             }
@@ -62,6 +63,7 @@ struct Patch : MoveableOnly<Patch>, SampleRateSupport
             {
                 p.resetBus();
                 p.address = (BusAddress)adr;
+                p.seedEffectRng();
                 adr++;
             }
             reconfigureSolo();
@@ -164,6 +166,7 @@ struct Patch : MoveableOnly<Patch>, SampleRateSupport
     } busses;
 
     void process(Engine &e);
+    void processPartsInParallel(Engine &e);
 
     void resetToBlankPatch()
     {
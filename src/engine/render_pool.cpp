@@ -0,0 +1,207 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "render_pool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "infrastructure/sse_include.h"
+
+namespace scxt::engine
+{
+namespace
+{
+// Best effort; most systems want a permission for this, and we run without it
+void raiseToRealtimePriority()
+{
+#if WINDOWS
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+        SCLOG_ONCE("Render pool workers could not raise their priority");
+#else
+    sched_param sp{};
+    sp.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) != 0)
+        SCLOG_ONCE("Render pool workers could not get realtime priority");
+#endif
+}
+} // namespace
+
+RenderPool::RenderPool(int workerCount)
+{
+    workerCount = std::clamp(workerCount, 0, maxWorkers);
+    participants = workerCount + 1;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+    SCLOG("Render pool started with " << workerCount << " workers");
+}
+
+RenderPool::~RenderPool() { stopWorkers(); }
+
+void RenderPool::stopWorkers()
+{
+    keepRunning = false;
+    parkCV.notify_all();
+    for (auto &w : workers)
+        w.join();
+    workers.clear();
+    participants = 1;
+}
+
+void RenderPool::useHostExecutor(hostExec_t exec, void *context)
+{
+    stopWorkers();
+    hostExec = exec;
+    hostContext = context;
+    SCLOG("Render pool using the host's thread pool");
+}
+
+void RenderPool::runHostTask(uint32_t task)
+{
+    if (task < batchSize)
+        job(batch[task]);
+}
+
+void RenderPool::render()
+{
+    if (batchSize == 0)
+        return;
+
+    if (hostExec)
+    {
+        if (!hostExec(hostContext, (uint32_t)batchSize))
+        {
+            for (size_t i = 0; i < batchSize; ++i)
+                job(batch[i]);
+        }
+        return;
+    }
+
+    auto gen = generation.load(std::memory_order_relaxed) + 1;
+    completed.store(0, std::memory_order_relaxed);
+
+    auto per = batchSize / participants;
+    auto extra = batchSize % participants;
+    size_t b{0};
+    for (int p = 0; p < participants; ++p)
+    {
+        auto e = b + per + ((size_t)p < extra ? 1 : 0);
+        cursors[p].value.store(packCursor(gen, e, b), std::memory_order_release);
+        b = e;
+    }
+    generation.store(gen, std::memory_order_release);
+
+    if (parkedWorkers.load(std::memory_order_acquire) > 0)
+        parkCV.notify_all();
+
+    // The audio thread is the last participant
+    runBatch(participants - 1, gen);
+
+    while (completed.load(std::memory_order_acquire) < batchSize)
+    {
+        _mm_pause();
+    }
+}
+
+void RenderPool::runBatch(int self, uint64_t gen)
+{
+    auto g = gen & genMask;
+    for (int i = 0; i < participants; ++i)
+    {
+        auto &c = cursors[(self + i) % participants].value;
+        auto w = c.load(std::memory_order_acquire);
+        while (true)
+        {
+            // A cursor from another generation means this batch is over for us. We
+            // never modify it, since it may belong to a batch we haven't seen.
+            if ((w >> (idxBits + endBits)) != g)
+                return;
+            auto idx = w & idxMask;
+            auto end = (w >> idxBits) & endMask;
+            if (idx >= end)
+                break;
+            if (!c.compare_exchange_weak(w, w + 1, std::memory_order_acq_rel,
+                                         std::memory_order_acquire))
+                continue;
+
+            job(batch[idx]);
+            completed.fetch_add(1, std::memory_order_release);
+            w = c.load(std::memory_order_acquire);
+        }
+    }
+}
+
+void RenderPool::workerLoop(int self)
+{
+    // Match the audio thread and flush denormals
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+    raiseToRealtimePriority();
+
+    // At realtime priority a spinning worker keeps its core from everything else, so
+    // only spin long enough to catch a batch which is right behind the last one
+    using clock_t = std::chrono::steady_clock;
+    static constexpr auto spinFor = std::chrono::milliseconds(1);
+
+    uint64_t lastGen{generation.load(std::memory_order_acquire)};
+    auto lastWork = clock_t::now();
+    while (keepRunning)
+    {
+        auto g = generation.load(std::memory_order_acquire);
+        if (g != lastGen)
+        {
+            lastGen = g;
+            runBatch(self, g);
+            lastWork = clock_t::now();
+            continue;
+        }
+
+        if (clock_t::now() - lastWork < spinFor)
+        {
+            _mm_pause();
+            continue;
+        }
+
+        parkedWorkers++;
+        {
+            std::unique_lock<std::mutex> lk(parkMutex);
+            parkCV.wait_for(lk, std::chrono::milliseconds(5), [this, lastGen]() {
+                return !keepRunning || generation.load(std::memory_order_acquire) != lastGen;
+            });
+        }
+        parkedWorkers--;
+    }
+}
+} // namespace scxt::engine
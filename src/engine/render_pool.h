@@ -0,0 +1,143 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_ENGINE_RENDER_POOL_H
+#define SCXT_SRC_ENGINE_RENDER_POOL_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utils.h"
+#include "configuration.h"
+
+namespace scxt::engine
+{
+/*
+ * The RenderPool lets the audio thread spread a batch of independent jobs (the
+ * voices of a part, or whole parts and their busses) across several cores. The
+ * audio thread collects a batch, the pool workers and the audio thread all run the
+ * job on its items, and render returns once every item is done. Callers reduce the
+ * results afterwards in their usual order, so output is identical to a serial render.
+ *
+ * Nothing on the audio thread locks or allocates. The batch is split into one
+ * contiguous partition per participant and each partition has a single atomic
+ * cursor which packs (generation, end, next). A participant drains its own
+ * partition and then steals from the others by bumping their cursors, and a
+ * cursor from an old generation is simply ignored, so a late worker can never
+ * pick up a stale index. Workers run at realtime priority where the OS lets them,
+ * since the audio thread waits on any item a worker has claimed. They spin briefly
+ * after each batch and then park on a condition variable (with a timeout); if a
+ * worker is late the audio thread steals its unclaimed items and does more of the
+ * work itself.
+ *
+ * A host with a thread pool of its own (the CLAP thread-pool extension) can take the
+ * batch over instead. Then we stop our workers, and render asks the host to run one
+ * task per item on its threads, which it does at the priority it runs audio at.
+ *
+ * Batches do not nest: a job must not itself use the pool.
+ */
+struct RenderPool : MoveableOnly<RenderPool>
+{
+    static constexpr int maxWorkers{15};
+    static constexpr size_t maxBatchSize{maxVoices};
+    using job_t = void (*)(void *);
+
+    explicit RenderPool(int workerCount);
+    ~RenderPool();
+
+    int getWorkerCount() const { return (int)workers.size(); }
+
+    // Audio thread API. Start a batch with a job, add items, then render them all.
+    void beginBatch(job_t j)
+    {
+        job = j;
+        batchSize = 0;
+    }
+    bool add(void *item)
+    {
+        if (batchSize >= batch.size())
+            return false;
+        batch[batchSize++] = item;
+        return true;
+    }
+    size_t size() const { return batchSize; }
+    void render();
+
+    /*
+     * Main thread, while audio is stopped. From now on render hands batches to exec,
+     * which should run runHostTask for each of numTasks on the host's threads and
+     * return once all are done, or return false to have us render the batch here.
+     */
+    using hostExec_t = bool (*)(void *context, uint32_t numTasks);
+    void useHostExecutor(hostExec_t exec, void *context);
+    void runHostTask(uint32_t task);
+
+  private:
+    static constexpr int idxBits{20}, endBits{20}, genBits{24};
+    static constexpr uint64_t idxMask{(1ULL << idxBits) - 1}, endMask{(1ULL << endBits) - 1},
+        genMask{(1ULL << genBits) - 1};
+    static uint64_t packCursor(uint64_t gen, uint64_t end, uint64_t idx)
+    {
+        return ((gen & genMask) << (idxBits + endBits)) | ((end & endMask) << idxBits) |
+               (idx & idxMask);
+    }
+
+    void runBatch(int self, uint64_t gen);
+    void workerLoop(int self);
+    void stopWorkers();
+
+    hostExec_t hostExec{nullptr};
+    void *hostContext{nullptr};
+
+    job_t job{nullptr};
+    std::array<void *, maxBatchSize> batch{};
+    size_t batchSize{0};
+
+    struct alignas(64) Cursor
+    {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Cursor, maxWorkers + 1> cursors;
+    int participants{1};
+
+    alignas(64) std::atomic<uint64_t> generation{0};
+    alignas(64) std::atomic<size_t> completed{0};
+
+    std::atomic<bool> keepRunning{true};
+    std::atomic<int> parkedWorkers{0};
+    std::mutex parkMutex;
+    std::condition_variable parkCV;
+    std::vector<std::thread> workers;
+};
+} // namespace scxt::engine
+
+#endif // SHORTCIRCUITXT_RENDER_POOL_H
@@ -60,7 +60,12 @@ template <bool OS> void Zone::processWithOS(scxt::engine::Engine &onto)
     // TODO these memsets are probably gratuitous
     memset(output, 0, sizeof(output));
 
-    mUILag.process();
+    if (!voicesRenderedAhead)
+    {
+        mUILag.process();
+        processSharedLFOs();
+    }
+    voicesRenderedAhead = false;
 
     std::array<voice::Voice *, maxVoices> toCleanUp;
     size_t cleanupIdx{0};
@@ -69,7 +74,9 @@ template <bool OS> void Zone::processWithOS(scxt::engine::Engine &onto)
     {
         if (v && v->isVoiceAssigned)
         {
-            if (v->process())
+            auto rendered = v->renderedAhead ? v->renderedAheadResult : v->process();
+            v->renderedAhead = false;
+            if (rendered)
             {
                 if (outputInfo.routeTo == DEFAULT_BUS)
                 {
@@ -102,8 +109,16 @@ template <bool OS> void Zone::processWithOS(scxt::engine::Engine &onto)
         }
     }
 
+    // Cleanup touches engine wide voice state, so if parts are rendering concurrently
+    // our part hands it back to the audio thread to do once they are done
+    auto deferCleanup = getEngine()->partsRenderingInParallel;
     for (int i = 0; i < cleanupIdx; ++i)
     {
+        if (deferCleanup)
+        {
+            parentGroup->parentPart->deferVoiceCleanup(toCleanUp[i]);
+            continue;
+        }
 #if DEBUG_VOICE_LIFECYCLE
         SCLOG("Cleanup Voice at " << SCDBGV((int)toCleanUp[i]->key));
 #endif
@@ -147,6 +162,7 @@ void Zone::removeVoice(voice::Voice *v)
             activeVoices--;
             if (activeVoices == 0)
             {
+                sharedLFOs.running.fill(false);
                 mUILag.instantlySnap();
                 parentGroup->removeActiveZone();
             }
@@ -156,6 +172,83 @@ void Zone::removeVoice(voice::Voice *v)
     assert(false);
 }
 
+float &Zone::sharedLFOOutput(int i)
+{
+    const auto &ms = modulatorStorage[i];
+    if (ms.isStep())
+        return sharedLFOs.stepLfos[i].output;
+    if (ms.isEnv())
+        return sharedLFOs.envLfos[i].output;
+    if (ms.isCurve())
+        return sharedLFOs.curveLfos[i].output;
+    return sharedLFOs.zeroOutput;
+}
+
+void Zone::processSharedLFOs()
+{
+    bool anyShared{false};
+    for (int i = 0; i < lfosPerZone; ++i)
+        anyShared = anyShared || isLFOShared(i);
+    if (!anyShared)
+        return;
+
+    bool gated{false};
+    for (const auto *v : voiceWeakPointers)
+    {
+        if (v && v->isVoiceAssigned && v->isGated)
+        {
+            gated = true;
+            break;
+        }
+    }
+
+    auto *e = getEngine();
+    for (int i = 0; i < lfosPerZone; ++i)
+    {
+        if (!isLFOShared(i))
+        {
+            sharedLFOs.running[i] = false;
+            continue;
+        }
+
+        auto &ms = modulatorStorage[i];
+        if (ms.isStep())
+        {
+            auto &lfo = sharedLFOs.stepLfos[i];
+            if (!sharedLFOs.running[i])
+            {
+                lfo.setSampleRate(sampleRate, sampleRateInv);
+                lfo.assign(&ms, &ms.rate, &e->transport, sharedLFOs.rng);
+            }
+            lfo.process(blockSize);
+        }
+        else if (ms.isCurve())
+        {
+            auto &lfo = sharedLFOs.curveLfos[i];
+            if (!sharedLFOs.running[i])
+            {
+                lfo.setSampleRate(sampleRate, sampleRateInv);
+                lfo.attack(ms.start_phase, ms.modulatorShape);
+            }
+            const auto &cs = ms.curveLfoStorage;
+            lfo.process(ms.rate, cs.deform, cs.delay, cs.attack, cs.release, cs.useenv,
+                        cs.unipolar, gated);
+        }
+        else if (ms.isEnv())
+        {
+            auto &lfo = sharedLFOs.envLfos[i];
+            const auto &es = ms.envLfoStorage;
+            if (!sharedLFOs.running[i])
+            {
+                lfo.setSampleRate(sampleRate, sampleRateInv);
+                lfo.attack(es.delay);
+            }
+            lfo.process(es.delay, es.attack, es.hold, es.decay, es.sustain, es.release, gated);
+        }
+        sharedLFOs.running[i] = true;
+    }
+}
+
 void Zone::setNormalizedSampleLevel(const bool usePeak, const int associatedSampleID)
 {
     const auto startSample = (associatedSampleID < 0) ? 0 : associatedSampleID;
@@ -202,6 +295,19 @@ const engine::Engine *Zone::getEngine() const
     return nullptr;
 }
 
+void Zone::onMappingChanged()
+{
+    if (parentGroup)
+        parentGroup->onZoneStructureChanged();
+}
+
+void Zone::onSampleOrLoopChanged()
+{
+    if (parentGroup)
+        if (auto e = parentGroup->getEngine())
+            e->compressedLoopSpansStale = true;
+}
+
 void Zone::initialize()
 {
     for (auto &v : voiceWeakPointers)
@@ -255,6 +361,7 @@ bool Zone::attachToSample(const sample::SampleManager &manager, int index,
             {
                 mapping.velocityRange = {m.vel_low, m.vel_high};
             }
+            onMappingChanged();
         }
     }
     if (sir & (LOOP | ENDPOINTS))
@@ -280,6 +387,7 @@ bool Zone::attachToSample(const sample::SampleManager &manager, int index,
             }
         }
     }
+    onSampleOrLoopChanged();
     return samplePointers[index] != nullptr;
 }
 
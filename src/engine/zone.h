@@ -36,9 +36,14 @@
 
 #include "sst/basic-blocks/dsp/Lag.h"
 #include "sample/sample_manager.h"
+#include "sample/compressed_playback.h"
 #include "dsp/processor/processor.h"
+#include "dsp/processor/warm_processor_pool.h"
 #include "modulation/voice_matrix.h"
 #include "modulation/modulator_storage.h"
+#include "modulation/modulators/steplfo.h"
+#include "modulation/modulators/curvelfo.h"
+#include "modulation/modulators/envlfo.h"
 
 #include "group_and_zone.h"
 
@@ -144,6 +149,14 @@ struct Zone : MoveableOnly<Zone>, HasGroupZoneProcessors<Zone>, SampleRateSuppor
     std::array<std::shared_ptr<sample::Sample>, maxVariantsPerZone> samplePointers;
     int8_t sampleIndex{-1};
 
+    /*
+     * The decoded loop of each looped variant on a compressed sample. Built on the
+     * serialization thread and swapped in on the audio thread by
+     * Engine::updateCompressedLoopSpans, which alone reads and writes the keys.
+     */
+    std::array<std::shared_ptr<sample::DecodedSpan>, maxVariantsPerZone> compressedLoopSpans;
+    std::array<sample::DecodedSpan::Key, maxVariantsPerZone> compressedLoopSpanKeys;
+
     int numAvail{0};
     int setupFor{0};
     int lastPlayed{-1};
@@ -222,6 +235,10 @@ struct Zone : MoveableOnly<Zone>, HasGroupZoneProcessors<Zone>, SampleRateSuppor
         float pitchOffset{0.0}; // semitones/keys
 
     } mapping;
+    // Call after changing key or velocity ranges so note-on lookup sees them
+    void onMappingChanged();
+    // Call after changing a variant's sample or loop so compressed loop spans follow
+    void onSampleOrLoopChanged();
 
     Group *parentGroup{nullptr};
 
@@ -231,6 +248,12 @@ struct Zone : MoveableOnly<Zone>, HasGroupZoneProcessors<Zone>, SampleRateSuppor
     int gatedVoiceCount{0};
     void terminateAllVoices();
 
+    /*
+     * If the engine has a voice render pool the part renders our voices ahead of
+     * process (see Part::renderVoicesAhead) and process just reduces the results.
+     */
+    bool voicesRenderedAhead{false};
+
     void initialize();
     // Just a weak ref - don't take ownership. engine manages lifetime
     void addVoice(voice::Voice *);
@@ -244,10 +267,35 @@ struct Zone : MoveableOnly<Zone>, HasGroupZoneProcessors<Zone>, SampleRateSuppor
     std::array<bool, lfosPerZone> lfosActive{};
     std::array<bool, egsPerZone> egsActive{};
 
+    /*
+     * Shared LFOs run here once a block, ahead of our voices, and the voices bind these
+     * outputs as their LFO sources instead of running their own. They use the unmodulated
+     * storage values, restart when the zone goes active and are gated while any voice is.
+     */
+    struct SharedLFOs
+    {
+        std::array<bool, lfosPerZone> running{};
+        modulation::modulators::StepLFO stepLfos[lfosPerZone];
+        modulation::modulators::CurveLFO curveLfos[lfosPerZone];
+        modulation::modulators::EnvLFO envLfos[lfosPerZone];
+        float zeroOutput{0.f};
+        // Zones process on render pool workers, so they can't share the engine's RNG
+        sst::basic_blocks::dsp::RNG rng;
+    } sharedLFOs;
+    bool isLFOShared(int i) const { return lfosActive[i] && modulatorStorage[i].shared; }
+    float &sharedLFOOutput(int i);
+    void processSharedLFOs();
+
     // 0 is the AEG, 1 is EG2
     std::array<modulation::modulators::AdsrStorage, 2> egStorage;
 
-    void onProcessorTypeChanged(int, dsp::processor::ProcessorType) {}
+    // Pre-spawned instances of the heavier processors which voices adopt; see
+    // WarmProcessorPool
+    dsp::processor::WarmProcessorPool warmProcessors;
+    void onProcessorTypeChanged(int w, dsp::processor::ProcessorType)
+    {
+        warmProcessors.dropIdle(w);
+    }
 
     void setupOnUnstream(const engine::Engine &e);
     engine::Engine *getEngine();
@@ -47,7 +47,7 @@ namespace scxt::infrastructure
 #if WINDOWS
 struct WinImpl : FileMapView::Impl
 {
-    WinImpl(const fs::path &fname) { init(fname.wstring()); }
+    WinImpl(const fs::path &fname, bool cow) : copyOnWrite(cow) { init(fname.wstring()); }
     ~WinImpl()
     {
         if (isMapped)
@@ -67,19 +67,29 @@ struct WinImpl : FileMapView::Impl
 
         hf = CreateFileW(fname.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
                          FILE_FLAG_SEQUENTIAL_SCAN, NULL);
-        if (!hf)
+        if (hf == INVALID_HANDLE_VALUE)
+        {
+            hf = 0;
             return;
+        }
         dataSize = GetFileSize(hf, NULL);
 
-        hmf = CreateFileMappingW(hf, 0, PAGE_READONLY, 0, 0, 0);
+        hmf = CreateFileMappingW(hf, 0, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, 0);
         if (!hmf)
         {
             dataSize = 0;
             CloseHandle(hf);
+            hf = 0;
             return;
         }
 
-        data = MapViewOfFile(hmf, FILE_MAP_READ, 0, 0, 0);
+        data = MapViewOfFile(hmf, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+
+        // The view keeps the mapping and file alive on its own, so we don't hold handles
+        CloseHandle(hmf);
+        CloseHandle(hf);
+        hmf = 0;
+        hf = 0;
 
         if (!data)
         {
@@ -87,10 +97,16 @@ struct WinImpl : FileMapView::Impl
             return;
         }
         isMapped = true;
+
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        pageSize = si.dwPageSize;
     }
     void *data = nullptr;
     size_t dataSize = 0;
+    size_t pageSize = 4096;
     bool isMapped = false;
+    bool copyOnWrite = false;
 
     HANDLE hf = 0, hmf = 0;
 
@@ -102,53 +118,56 @@ WinImpl *as(FileMapView::Impl *imp) { return reinterpret_cast<WinImpl *>(imp); }
 #else
 struct posixImpl : FileMapView::Impl
 {
-    posixImpl(const fs::path &fname) { init(fname); }
+    // Our posix mapping is always private, so it is always copy on write
+    posixImpl(const fs::path &fname, bool) { init(fname); }
     ~posixImpl()
     {
         if (isMapped)
-        {
             munmap(data, dataSize);
-            close(fd);
-        }
     }
     void init(const fs::path &fname)
     {
         struct stat sb;
-        fd = open(fname.u8string().c_str(), O_RDONLY);
-        if (!fd)
+        auto fd = open(fname.u8string().c_str(), O_RDONLY);
+        if (fd < 0)
         {
             isMapped = false;
             return;
         }
         fstat(fd, &sb);
         data = mmap(nullptr, sb.st_size, PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+        // The mapping holds its own reference to the file, so a sample mapped for its
+        // whole life doesn't cost us a descriptor against the open file limit
+        close(fd);
+
         if (data == MAP_FAILED)
         {
             isMapped = false;
-            close(fd);
             data = nullptr;
             dataSize = 0;
             return;
         }
         isMapped = true;
         dataSize = sb.st_size;
+        pageSize = sysconf(_SC_PAGESIZE);
     }
     void *data = nullptr;
     size_t dataSize = 0;
+    size_t pageSize = 4096;
     bool isMapped = false;
-
-    int fd = 0;
+    bool copyOnWrite = true;
 };
 
 posixImpl *as(FileMapView::Impl *imp) { return reinterpret_cast<posixImpl *>(imp); }
 #endif
 
-FileMapView::FileMapView(const fs::path &fname)
+FileMapView::FileMapView(const fs::path &fname, bool copyOnWrite)
 {
 #if WINDOWS
-    impl = std::make_unique<WinImpl>(fname);
+    impl = std::make_unique<WinImpl>(fname, copyOnWrite);
 #else
-    impl = std::make_unique<posixImpl>(fname);
+    impl = std::make_unique<posixImpl>(fname, copyOnWrite);
 #endif
 }
 
@@ -160,4 +179,14 @@ size_t FileMapView::dataSize() { return as(impl.get())->dataSize; }
 
 bool FileMapView::isMapped() { return as(impl.get())->isMapped; }
 
+size_t FileMapView::readableSize()
+{
+    auto i = as(impl.get());
+    if (!i->isMapped)
+        return 0;
+    return (i->dataSize + i->pageSize - 1) / i->pageSize * i->pageSize;
+}
+
+bool FileMapView::isCopyOnWrite() { return as(impl.get())->copyOnWrite; }
+
 } // namespace scxt::infrastructure
\ No newline at end of file
@@ -47,6 +47,9 @@ namespace scxt::infrastructure
  * auto d = mapper->data; // valid until mapper is destroyed
  * auto s = mapper->dataSize;
  * ```
+ *
+ * The file is closed once it is mapped, so a view holds no file handle or descriptor
+ * and you can keep as many alive as memory allows.
  */
 class FileMapView
 {
@@ -54,14 +57,24 @@ class FileMapView
     /**
      * Construct a view of a file
      * @param filename the path to the file to be mapped. If unavabiable, isMapped will return false
+     * @param copyOnWrite if true the view is private and writable; writes are never seen
+     * by the file or by other views, and only the pages you touch get copied.
      */
-    FileMapView(const fs::path &filename);
+    FileMapView(const fs::path &filename, bool copyOnWrite = false);
     ~FileMapView();
 
     bool isMapped();
     void *data();
     size_t dataSize();
 
+    /**
+     * The number of bytes from data() you can read. Since mappings are made in whole
+     * pages this is dataSize() rounded up to the page size, with the bytes past the
+     * end of the file reading as zero.
+     */
+    size_t readableSize();
+    bool isCopyOnWrite();
+
     struct Impl
     {
         virtual ~Impl() = default;
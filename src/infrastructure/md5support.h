@@ -29,12 +29,28 @@
 #define SCXT_SRC_INFRASTRUCTURE_MD5SUPPORT_H
 
 #include <string>
+#include <optional>
+#include <cstdint>
 #include "filesystem_import.h"
 #include "file_map_view.h"
 #include "md5.h"
 
 namespace scxt::infrastructure
 {
+/*
+ * Hashing large SF2 or multisample archives dominates load time, so callers can
+ * provide a persistent cache keyed by path, size and modification time. The browser
+ * database implements this.
+ */
+struct MD5Cache
+{
+    virtual ~MD5Cache() = default;
+    virtual std::optional<std::string> getCachedMD5Sum(const fs::path &path, uint64_t size,
+                                                       int64_t modTime) = 0;
+    virtual void setCachedMD5Sum(const fs::path &path, uint64_t size, int64_t modTime,
+                                 const std::string &md5) = 0;
+};
+
 inline std::string createMD5SumFromFile(const fs::path &path)
 {
     auto fmp = infrastructure::FileMapView(path);
@@ -44,5 +60,27 @@ inline std::string createMD5SumFromFile(const fs::path &path)
     return md5::MD5::Hash(fmp.data(), fmp.dataSize());
 }
 
+inline std::string createMD5SumFromFile(const fs::path &path, MD5Cache *cache)
+{
+    if (!cache)
+        return createMD5SumFromFile(path);
+
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (ec)
+        return createMD5SumFromFile(path);
+    auto modTime = (int64_t)fs::last_write_time(path, ec).time_since_epoch().count();
+    if (ec)
+        return createMD5SumFromFile(path);
+
+    if (auto res = cache->getCachedMD5Sum(path, size, modTime); res.has_value())
+        return *res;
+
+    auto res = createMD5SumFromFile(path);
+    if (!res.empty())
+        cache->setCachedMD5Sum(path, size, modTime, res);
+    return res;
+}
+
 } // namespace scxt::infrastructure
 #endif // SHORTCIRCUITXT_MD5SUPPORT_H
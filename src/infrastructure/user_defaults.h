@@ -42,6 +42,14 @@ enum DefaultKeys
     colormapPathIfFile,
     welcomeScreenSeen,
     playModeExpanded,
+    streamLargeSamples,
+    mapSamplesWithoutCopy,
+    decodedSampleCacheSizeInMB,
+    renderThreads,
+    parallelParts,
+    precomputeDecimatedSamples,
+    compressSamplesInMemory,
+    audioRatePitchModulation,
 
     nKeys // must be last K?
 };
@@ -67,6 +75,22 @@ inline std::string defaultKeyToString(DefaultKeys k)
         return "welcomeScreenSeen";
     case playModeExpanded:
         return "playModeExpanded";
+    case streamLargeSamples:
+        return "streamLargeSamples";
+    case mapSamplesWithoutCopy:
+        return "mapSamplesWithoutCopy";
+    case decodedSampleCacheSizeInMB:
+        return "decodedSampleCacheSizeInMB";
+    case renderThreads:
+        return "renderThreads";
+    case parallelParts:
+        return "parallelParts";
+    case precomputeDecimatedSamples:
+        return "precomputeDecimatedSamples";
+    case compressSamplesInMemory:
+        return "compressSamplesInMemory";
+    case audioRatePitchModulation:
+        return "audioRatePitchModulation";
     default:
         std::terminate(); // for now
     }
@@ -132,6 +132,7 @@ SC_STREAMDEF(scxt::modulation::ModulatorStorage, SC_FROM({
                       {"rate", t.rate},
                       {"start_phase", t.start_phase},
                       {"temposync", t.temposync},
+                      {"shared", t.shared},
 
                       {"curveLfoStorage", t.curveLfoStorage},
                       {"stepLfoStorage", t.stepLfoStorage},
@@ -144,6 +145,7 @@ SC_STREAMDEF(scxt::modulation::ModulatorStorage, SC_FROM({
                  findIf(v, "rate", result.rate);
                  findIf(v, "start_phase", result.start_phase);
                  findIf(v, "temposync", result.temposync);
+                 findOrSet(v, "shared", false, result.shared);
                  findIf(v, "curveLfoStorage", result.curveLfoStorage);
                  findIf(v, "stepLfoStorage", result.stepLfoStorage);
                  findIf(v, "envLfoStorage", result.envLfoStorage);
@@ -72,6 +72,9 @@ std::string streamEngineState(const engine::Engine &e, bool pretty)
 
 void unstreamEngineState(engine::Engine &e, const std::string &data, bool msgPack)
 {
+    auto cng = messaging::MessageController::ClientActivityNotificationGuard(
+        "Loading Multi", *(e.getMessageController()));
+
     e.clearAll();
     if (msgPack)
     {
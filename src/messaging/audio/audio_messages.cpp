@@ -40,4 +40,31 @@ void sendStructureRefresh(MessageController &mc)
     a2s.payloadType = AudioToSerialization::NONE;
     mc.sendAudioToSerialization(a2s);
 }
+
+void sendMemoryPoolRefill(MessageController &mc)
+{
+    assert(mc.threadingChecker.isAudioThread());
+    AudioToSerialization a2s;
+    a2s.id = a2s_memory_pool_refill;
+    a2s.payloadType = AudioToSerialization::NONE;
+    mc.sendAudioToSerialization(a2s);
+}
+
+void sendZoneIndexRebuild(MessageController &mc)
+{
+    assert(mc.threadingChecker.isAudioThread());
+    AudioToSerialization a2s;
+    a2s.id = a2s_zone_index_rebuild;
+    a2s.payloadType = AudioToSerialization::NONE;
+    mc.sendAudioToSerialization(a2s);
+}
+
+void sendCompressedLoopSpansStale(MessageController &mc)
+{
+    assert(mc.threadingChecker.isAudioThread());
+    AudioToSerialization a2s;
+    a2s.id = a2s_compressed_loop_spans_stale;
+    a2s.payloadType = AudioToSerialization::NONE;
+    mc.sendAudioToSerialization(a2s);
+}
 } // namespace scxt::messaging::audio
\ No newline at end of file
@@ -54,6 +54,9 @@ enum AudioToSerializationMessageId
     a2s_processor_refresh,
     a2s_macro_updated,
     a2s_delete_this_pointer,
+    a2s_memory_pool_refill,
+    a2s_zone_index_rebuild,
+    a2s_compressed_loop_spans_stale,
 };
 
 /**
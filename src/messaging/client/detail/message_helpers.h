@@ -68,6 +68,16 @@ updateZoneLeadMemberValue(M m, const diffMsg_t<VT> &payload, const engine::Engin
                 {
                     *(VT *)(((uint8_t *)&dat) + d) = v;
                 }
+                if constexpr (std::is_same_v<std::remove_reference_t<decltype(dat)>,
+                                             engine::Zone::ZoneMappingData>)
+                {
+                    zn->onMappingChanged();
+                }
+                if constexpr (std::is_same_v<std::remove_reference_t<decltype(dat)>,
+                                             engine::Zone::Variants>)
+                {
+                    zn->onSampleOrLoopChanged();
+                }
             },
             responseCB);
     }
@@ -107,6 +117,16 @@ inline void updateZoneMemberValue(M m, const diffMsg_t<VT> &payload, const engin
                     {
                         *(VT *)(((uint8_t *)&dat) + d) = v;
                     }
+                    if constexpr (std::is_same_v<std::remove_reference_t<decltype(dat)>,
+                                                 engine::Zone::ZoneMappingData>)
+                    {
+                        zn->onMappingChanged();
+                    }
+                    if constexpr (std::is_same_v<std::remove_reference_t<decltype(dat)>,
+                                                 engine::Zone::Variants>)
+                    {
+                        zn->onSampleOrLoopChanged();
+                    }
                 }
             },
             responseCB);
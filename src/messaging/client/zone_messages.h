@@ -33,6 +33,7 @@
 #include "json/engine_traits.h"
 #include "json/datamodel_traits.h"
 #include "selection/selection_manager.h"
+#include "dsp/sample_analytics.h"
 
 namespace scxt::messaging::client
 {
@@ -58,7 +59,9 @@ inline void doUpdateLeadZoneMapping(const engine::Zone::ZoneMappingData &payload
         cont.scheduleAudioThreadCallback(
             [zs = *sz, mapv = mapping](auto &eng) {
                 auto [p, g, z] = zs;
-                eng.getPatch()->getPart(p)->getGroup(g)->getZone(z)->mapping = mapv;
+                auto &zn = eng.getPatch()->getPart(p)->getGroup(g)->getZone(z);
+                zn->mapping = mapv;
+                zn->onMappingChanged();
             },
             [p = sz->part](const auto &eng) {
                 serializationSendToClient(
@@ -105,7 +108,9 @@ inline void doUpdateLeadZoneSingleVariant(const updateLeadZoneSingleVariantPaylo
         auto [ps, gs, zs] = *sz;
         cont.scheduleAudioThreadCallback([p = ps, g = gs, z = zs, sampv = samples](auto &eng) {
             auto &[idx, smp] = sampv;
-            eng.getPatch()->getPart(p)->getGroup(g)->getZone(z)->variantData.variants[idx] = smp;
+            auto &zone = eng.getPatch()->getPart(p)->getGroup(g)->getZone(z);
+            zone->variantData.variants[idx] = smp;
+            zone->onSampleOrLoopChanged();
         });
     }
 }
@@ -122,6 +127,11 @@ inline void doNormalizeVariantAmplitude(const normalizeVariantAmplitudePayload_t
     if (sz.has_value())
     {
         auto [ps, gs, zs] = *sz;
+        // Measuring reads every frame, so do it here rather than on the audio thread
+        const auto &zone = engine.getPatch()->getPart(ps)->getGroup(gs)->getZone(zs);
+        for (const auto &s : zone->samplePointers)
+            if (s && !s->levelsCached)
+                dsp::sample_analytics::cacheLevels(*s);
         cont.scheduleAudioThreadCallback([p = ps, g = gs, z = zs, sampv = samples](auto &eng) {
             auto &[idx, use_peak] = sampv;
             eng.getPatch()->getPart(p)->getGroup(g)->getZone(z)->setNormalizedSampleLevel(use_peak,
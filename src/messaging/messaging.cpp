@@ -89,6 +89,15 @@ void MessageController::parseAudioMessageOnSerializationThread(
         }
     }
     break;
+    case audio::a2s_memory_pool_refill:
+        engine.getMemoryPool()->refill();
+        break;
+    case audio::a2s_zone_index_rebuild:
+        engine.rebuildZoneIndicesOnSerialThread();
+        break;
+    case audio::a2s_compressed_loop_spans_stale:
+        engine.updateCompressedLoopSpans();
+        break;
     case audio::a2s_none:
         break;
     }
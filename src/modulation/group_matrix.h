@@ -57,7 +57,7 @@ struct GroupMatrixConfig
     using RoutingExtraPayload = scxt::modulation::shared::RoutingExtraPayload;
 
     using CurveIdentifier = scxt::modulation::ModulationCurves::CurveIdentifier;
-    static std::function<float(float)> getCurveOperator(CurveIdentifier id)
+    static scxt::modulation::ModulationCurves::curveFn_t getCurveOperator(CurveIdentifier id)
     {
         return scxt::modulation::ModulationCurves::getCurveOperator(id);
     }
@@ -32,6 +32,6 @@ namespace scxt::modulation
 std::vector<ModulationCurves::CurveIdentifier> ModulationCurves::allCurves;
 std::unordered_map<ModulationCurves::CurveIdentifier, std::pair<std::string, std::string>>
     ModulationCurves::curveNames;
-std::unordered_map<ModulationCurves::CurveIdentifier, std::function<float(float)>>
+std::unordered_map<ModulationCurves::CurveIdentifier, ModulationCurves::curveFn_t>
     ModulationCurves::curveImpls;
 } // namespace scxt::modulation
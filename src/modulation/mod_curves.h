@@ -47,9 +47,13 @@ struct ModulationCurves
 
     using CurveIdentifier = uint32_t;
 
+    // Curves are captureless so we keep them as plain function pointers. How the matrix
+    // stores and calls the operator it is handed is up to FixedMatrix in sst-basic-blocks.
+    using curveFn_t = float (*)(float);
+
     static std::vector<CurveIdentifier> allCurves;
     static std::unordered_map<CurveIdentifier, std::pair<std::string, std::string>> curveNames;
-    static std::unordered_map<CurveIdentifier, std::function<float(float)>> curveImpls;
+    static std::unordered_map<CurveIdentifier, curveFn_t> curveImpls;
 
     static inline void initializeCurves()
     {
@@ -60,7 +64,7 @@ struct ModulationCurves
             return;
 
         auto add = [](uint32_t tag, const std::string &cat, const std::string &nm,
-                      std::function<float(float)> fn) {
+                      curveFn_t fn) {
             auto ci = CurveIdentifier{tag};
             assert(curveNames.find(ci) == curveNames.end());
             allCurves.push_back(ci);
@@ -85,9 +89,9 @@ struct ModulationCurves
         add('cmnh', "Comparators", "x < 1/2", [](auto x) { return x < 0.5f ? 1.f : 0.f; });
 
         add('sinx', "Waveforms", std::string("sin(2") + u8"\U000003C0" + "x)", // thats pi
-            [](auto x) { return std::sin(2.0 * M_PI * x); });
+            [](float x) -> float { return std::sin(2.0 * M_PI * x); });
         add('cosx', "Waveforms", std::string("cos(2") + u8"\U000003C0" + "x)", // thats pi
-            [](auto x) { return std::cos(2.0 * M_PI * x); });
+            [](float x) -> float { return std::cos(2.0 * M_PI * x); });
         add('trix', "Waveforms", std::string("tri(x)"), [](auto x) -> float {
             auto res = 0.f;
             if (x < 0)
@@ -126,11 +130,11 @@ struct ModulationCurves
             return res;
         });
 
-        add('d.1 ', "Scale", "x / 10", [](auto x) { return x * 0.1; });
-        add('d.01', "Scale", "x / 100", [](auto x) { return x * 0.01; });
+        add('d.1 ', "Scale", "x / 10", [](float x) -> float { return x * 0.1; });
+        add('d.01', "Scale", "x / 100", [](float x) -> float { return x * 0.01; });
     }
 
-    static std::function<float(float)> getCurveOperator(CurveIdentifier id)
+    static curveFn_t getCurveOperator(CurveIdentifier id)
     {
         auto ptr = curveImpls.find(id);
         assert(ptr != curveImpls.end());
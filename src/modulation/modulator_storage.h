@@ -113,6 +113,10 @@ struct ModulatorStorage
     float start_phase{0.f};
     bool temposync{false};
 
+    // A shared (zone) LFO runs once per zone rather than once per voice, so every voice
+    // sees the same unmodulated LFO. See Zone::processSharedLFOs.
+    bool shared{false};
+
     modulators::StepLFOStorage stepLfoStorage;
     modulators::CurveLFOStorage curveLfoStorage;
     modulators::EnvLFOStorage envLfoStorage;
@@ -203,6 +207,7 @@ SC_DESCRIBE(scxt::modulation::ModulatorStorage, {
                                   {modulation::ModulatorStorage::ONESHOT, "ONESHOT"},
                               }));
     SC_FIELD(temposync, pmd().asBool().withName("Temposync"));
+    SC_FIELD(shared, pmd().asBool().withName("Shared"));
     SC_FIELD(rate, pmd().asLfoRate().withName("Rate"));
     SC_FIELD(start_phase, pmd().asPercent().withName("Phase"));
 
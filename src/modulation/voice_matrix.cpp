@@ -43,6 +43,128 @@ std::unordered_set<MatrixConfig::TargetIdentifier> MatrixConfig::multiplicativeT
 namespace shmo = scxt::modulation::shared;
 sst::basic_blocks::dsp::RNG rng;
 
+void Matrix::bindTargetBaseValue(const TI &t, float &f)
+{
+    base_t::bindTargetBaseValue(t, f);
+    for (size_t i = 0; i < activeRoutes; ++i)
+    {
+        auto &r = routes[i];
+        if (r.target == t)
+        {
+            r.base = &f;
+            r.out = base_t::getTargetValuePointer(t);
+        }
+    }
+}
+
+void Matrix::prepare(RoutingTable &rt)
+{
+    base_t::prepare(rt);
+
+    activeRoutes = 0;
+    modulatesDepth = false;
+    inputsUnseen = true;
+    for (size_t row = 0; row < rt.routes.size(); ++row)
+    {
+        auto &rr = rt.routes[row];
+        if (!rr.active || !rr.target.has_value() || !rr.source.has_value())
+            continue;
+        if (MatrixConfig::isTargetModMatrixDepth(*rr.target))
+            modulatesDepth = true;
+
+        // Keep the routes to one target together, in row order
+        size_t at{activeRoutes};
+        for (size_t i = 0; i < activeRoutes; ++i)
+        {
+            if (routes[i].target == *rr.target)
+                at = i + 1;
+        }
+        for (auto i = activeRoutes; i > at; --i)
+            routes[i] = routes[i - 1];
+
+        auto &r = routes[at];
+        r = ActiveRoute();
+        r.row = row;
+        r.target = *rr.target;
+        r.multiplicative = MatrixConfig::getIsMultiplicative(r.target);
+        auto s = sourcePointers.find(*rr.source);
+        if (s != sourcePointers.end())
+            r.source = s->second;
+        if (rr.sourceVia.has_value())
+        {
+            auto v = sourcePointers.find(*rr.sourceVia);
+            if (v != sourcePointers.end())
+                r.via = v->second;
+        }
+        r.depth = &rr.depth;
+        if (rr.curve.has_value())
+            r.curve = MatrixConfig::getCurveOperator(*rr.curve);
+        activeRoutes++;
+    }
+
+    for (size_t i = 0; i < activeRoutes; ++i)
+        routes[i].startsTarget = (i == 0 || !(routes[i - 1].target == routes[i].target));
+}
+
+void Matrix::process()
+{
+    if (activeRoutes == 0)
+        return;
+
+    if (modulatesDepth)
+    {
+        base_t::process();
+        return;
+    }
+
+    size_t i{0};
+    while (i < activeRoutes)
+    {
+        auto end = i + 1;
+        while (end < activeRoutes && !routes[end].startsTarget)
+            ++end;
+
+        auto &head = routes[i];
+        if (!head.out || !head.base)
+        {
+            i = end;
+            continue;
+        }
+
+        bool changed{inputsUnseen || *head.base != head.lastBase};
+        head.lastBase = *head.base;
+        for (auto j = i; j < end; ++j)
+        {
+            auto &r = routes[j];
+            auto s = r.source ? *r.source : 0.f;
+            auto v = r.via ? *r.via : 1.f;
+            changed = changed || s != r.lastSource || v != r.lastVia || *r.depth != r.lastDepth;
+            r.lastSource = s;
+            r.lastVia = v;
+            r.lastDepth = *r.depth;
+        }
+
+        if (changed)
+        {
+            auto val = head.lastBase;
+            for (auto j = i; j < end; ++j)
+            {
+                auto &r = routes[j];
+                if (!r.source)
+                    continue;
+                auto s = (r.curve ? r.curve(r.lastSource) : r.lastSource) * r.lastVia;
+                if (r.multiplicative)
+                    val *= 1.f + s * r.lastDepth;
+                else
+                    val += s * r.lastDepth * routingValuePointers[r.row].depthScale;
+            }
+            *head.out = val;
+        }
+        i = end;
+    }
+    inputsUnseen = false;
+}
+
 void MatrixEndpoints::bindTargetBaseValues(scxt::voice::modulation::Matrix &m, engine::Zone &z)
 {
     for (auto &l : lfo)
@@ -128,6 +250,11 @@ void MatrixEndpoints::Sources::bind(scxt::voice::modulation::Matrix &m, engine::
                                     voice::Voice &v)
 {
     lfoSources.bind(m, v, zeroSource);
+    for (int i = 0; i < lfosPerZone; ++i)
+    {
+        if (z.isLFOShared(i))
+            m.bindSourceValue(lfoSources.sources[i], z.sharedLFOOutput(i));
+    }
 
     m.bindSourceValue(aegSource, v.aeg.outBlock0);
     m.bindSourceValue(eg2Source, v.eg2.outBlock0);
@@ -59,7 +59,8 @@ struct MatrixConfig
     using TargetIdentifier = scxt::modulation::shared::TargetIdentifier;
 
     using CurveIdentifier = scxt::modulation::ModulationCurves::CurveIdentifier;
-    static std::function<float(float)> getCurveOperator(CurveIdentifier id)
+    using curveFn_t = scxt::modulation::ModulationCurves::curveFn_t;
+    static scxt::modulation::ModulationCurves::curveFn_t getCurveOperator(CurveIdentifier id)
     {
         return scxt::modulation::ModulationCurves::getCurveOperator(id);
     }
@@ -95,9 +96,58 @@ namespace scxt::voice::modulation
 {
 struct Matrix : sst::basic_blocks::mod_matrix::FixedMatrix<MatrixConfig>
 {
+    using base_t = sst::basic_blocks::mod_matrix::FixedMatrix<MatrixConfig>;
+
     bool forUIMode{false};
     std::unordered_map<MatrixConfig::TargetIdentifier, datamodel::pmd> activeTargetsToPMD;
     std::unordered_map<MatrixConfig::TargetIdentifier, float> activeTargetsToBaseValue;
+
+    /*
+     * Most voices use a couple of routes and plenty use none, but the base process
+     * walks every row every block. So prepare flattens the rows which can do anything
+     * into routes, grouped by target, and process evaluates just those. A target whose
+     * base value and route inputs are the same as last block keeps its output, and a
+     * target without a route reads its base value directly.
+     *
+     * We see sources and target base values as they are bound (in that order, around
+     * prepare) by shadowing the base binds. Routes which modulate another row's depth
+     * are rare enough that a matrix with one just runs the base process.
+     */
+    using SI = MatrixConfig::SourceIdentifier;
+    using TI = MatrixConfig::TargetIdentifier;
+
+    void bindSourceValue(const SI &s, float &f)
+    {
+        sourcePointers[s] = &f;
+        base_t::bindSourceValue(s, f);
+    }
+    void bindSourceConstantValue(const SI &s, float f)
+    {
+        sourceConstants[s] = f;
+        sourcePointers[s] = &sourceConstants[s];
+        base_t::bindSourceConstantValue(s, f);
+    }
+    void bindTargetBaseValue(const TI &t, float &f);
+
+    void prepare(RoutingTable &rt);
+    void process();
+
+    struct ActiveRoute
+    {
+        size_t row{0};
+        TI target;
+        bool startsTarget{false}, multiplicative{false};
+        const float *source{nullptr}, *via{nullptr}, *depth{nullptr}, *base{nullptr};
+        float *out{nullptr};
+        MatrixConfig::curveFn_t curve{nullptr};
+        float lastSource{0.f}, lastVia{0.f}, lastDepth{0.f}, lastBase{0.f};
+    };
+    std::array<ActiveRoute, MatrixConfig::FixedMatrixSize> routes{};
+    size_t activeRoutes{0};
+    bool modulatesDepth{false}, inputsUnseen{true};
+
+    std::unordered_map<SI, const float *> sourcePointers;
+    std::unordered_map<SI, float> sourceConstants;
 };
 
 struct MatrixEndpoints
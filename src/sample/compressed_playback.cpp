@@ -0,0 +1,147 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "compressed_playback.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "sample.h"
+
+namespace scxt::sample
+{
+std::unique_ptr<DecodedSpan> DecodedSpan::build(const Sample &s, int64_t start, int64_t end)
+{
+    assert(s.isCompressed());
+    const auto &frames = *s.compressedFrames;
+
+    auto res = std::make_unique<DecodedSpan>();
+    res->key = {&s, s.id, start, end};
+    res->asFloat = frames.bitsPerSample > 16;
+
+    auto elementSize = res->asFloat ? sizeof(float) : sizeof(int16_t);
+    auto bytes = (end - start + 2 * dsp::samplePadding) * elementSize;
+    std::vector<int32_t> scratch(CompressedFrames::blockFrames);
+    for (int c = 0; c < s.channels; ++c)
+    {
+        res->data[c] = std::make_unique<uint8_t[]>(bytes);
+        memset(res->data[c].get(), 0, bytes);
+        frames.decodeFrames(c, start, end, res->asFloat, res->channelData(c), scratch.data());
+    }
+    return res;
+}
+
+DecodedSpan::Key DecodedSpan::loopSpanKey(const Sample &s, int64_t startLoop, int64_t endLoop,
+                                          int64_t loopFade)
+{
+    // Enough either side that any block which could wrap or fade reads only from the span
+    static constexpr int64_t margin{CompressedVoiceWindow::blockFrames};
+
+    int64_t length = s.sample_length;
+    auto start = std::clamp(startLoop - loopFade - (int64_t)(2 * dsp::samplePadding) - margin,
+                            (int64_t)0, length);
+    auto end = std::clamp(endLoop + (int64_t)(2 * dsp::samplePadding) + margin, (int64_t)0, length);
+    if (end <= (int64_t)s.getResidentLength() || end <= start)
+        return {};
+    return {&s, s.id, start, end};
+}
+
+void CompressedVoiceWindow::attach(const Sample &s, uint8_t *block)
+{
+    assert(s.isCompressed());
+    frames = s.compressedFrames.get();
+    memory = block;
+    asFloat = frames->bitsPerSample > 16;
+    elementSize = asFloat ? sizeof(float) : sizeof(int16_t);
+    channels = std::min((int)s.channels, 2);
+    windowStart = 0;
+    windowEnd = 0;
+
+    // The padding either side is only read at the ends of the sample, so is always zero
+    for (int c = 0; c < channels; ++c)
+    {
+        auto *d = memory + c * channelBytes;
+        memset(d, 0, dsp::samplePadding * elementSize);
+        memset(d + (dsp::samplePadding + windowFrames) * elementSize, 0,
+               dsp::samplePadding * elementSize);
+    }
+}
+
+void CompressedVoiceWindow::detach()
+{
+    frames = nullptr;
+    memory = nullptr;
+    windowStart = 0;
+    windowEnd = 0;
+}
+
+bool CompressedVoiceWindow::prepare(int64_t lo, int64_t hi, bool forward)
+{
+    assert(memory);
+    if (windowEnd > windowStart && lo >= windowStart && hi <= windowEnd)
+        return true;
+
+    // Window starts are whole blocks, so one block of the window can be lost to alignment
+    if (hi - lo > windowFrames - blockFrames)
+        return false;
+
+    int64_t newStart;
+    if (forward)
+        newStart = lo / blockFrames * blockFrames;
+    else
+        newStart = std::max((int64_t)0,
+                            (hi + blockFrames - 1) / blockFrames * blockFrames - windowFrames);
+    auto newEnd = newStart + windowFrames;
+
+    auto *scratch = (int32_t *)(memory + 2 * channelBytes);
+    auto keepLo = std::max(newStart, windowStart);
+    auto keepHi = std::min(newEnd, windowEnd);
+    for (int c = 0; c < channels; ++c)
+    {
+        auto *d = (uint8_t *)channelData(c);
+        if (keepHi > keepLo)
+        {
+            memmove(d + (keepLo - newStart) * elementSize, d + (keepLo - windowStart) * elementSize,
+                    (keepHi - keepLo) * elementSize);
+            if (keepLo > newStart)
+                frames->decodeFrames(c, newStart, keepLo, asFloat, d, scratch);
+            if (newEnd > keepHi)
+                frames->decodeFrames(c, keepHi, newEnd, asFloat,
+                                     d + (keepHi - newStart) * elementSize, scratch);
+        }
+        else
+        {
+            frames->decodeFrames(c, newStart, newEnd, asFloat, d, scratch);
+        }
+    }
+    windowStart = newStart;
+    windowEnd = newEnd;
+    return true;
+}
+} // namespace scxt::sample
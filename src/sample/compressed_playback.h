@@ -0,0 +1,130 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SAMPLE_COMPRESSED_PLAYBACK_H
+#define SCXT_SRC_SAMPLE_COMPRESSED_PLAYBACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "utils.h"
+#include "dsp/resampling.h"
+#include "sample_compression.h"
+
+namespace scxt::sample
+{
+struct Sample;
+
+/*
+ * Playback of samples kept compressed with Sample::compressResidentData. Everything
+ * here decodes in the thread which needs the audio, so there are no slots to run out
+ * of and nothing to wait for.
+ *
+ * A DecodedSpan is a contiguous decoded range of a compressed sample, laid out like
+ * sampleData with samplePadding either side. Zones keep one covering each looped
+ * variant's loop, built on the serialization thread, so a loop of any length plays
+ * exactly as it would from a fully resident sample.
+ */
+struct DecodedSpan
+{
+    struct Key
+    {
+        const Sample *sample{nullptr};
+        SampleID sampleID{};
+        int64_t start{0}, end{0};
+        bool operator==(const Key &o) const
+        {
+            return sample == o.sample && sampleID == o.sampleID && start == o.start &&
+                   end == o.end;
+        }
+        bool operator!=(const Key &o) const { return !(*this == o); }
+    } key;
+    bool asFloat{false};
+
+    // Serialization thread. Decodes frames [start, end) of s
+    static std::unique_ptr<DecodedSpan> build(const Sample &s, int64_t start, int64_t end);
+
+    bool covers(int64_t lo, int64_t hi) const { return lo >= key.start && hi <= key.end; }
+    void *channelData(int c) const
+    {
+        if (!data[c])
+            return nullptr;
+        return data[c].get() + dsp::samplePadding * (asFloat ? sizeof(float) : sizeof(int16_t));
+    }
+
+    // The span a zone keeps for a loop, or an empty key if the loop is in the head
+    static Key loopSpanKey(const Sample &s, int64_t startLoop, int64_t endLoop,
+                           int64_t loopFade);
+
+  private:
+    std::unique_ptr<uint8_t[]> data[2];
+};
+
+/*
+ * A CompressedVoiceWindow is a voice's own decode window of windowFrames, in memory the
+ * voice checks out of the engine MemoryPool. Each block the voice asks for the range
+ * of frames it could read and the window slides to cover it, keeping the whole blocks
+ * it already holds and decoding the rest synchronously. Playing straight through a
+ * sample that decodes every CompressedFrames block once.
+ */
+struct CompressedVoiceWindow
+{
+    static constexpr int64_t blockFrames{CompressedFrames::blockFrames};
+    static constexpr int64_t windowFrames{4 * blockFrames};
+    static constexpr size_t channelBytes{(windowFrames + 2 * dsp::samplePadding) *
+                                         sizeof(float)};
+    static constexpr size_t poolBlockBytes{2 * channelBytes + blockFrames * sizeof(int32_t)};
+
+    // block must be poolBlockBytes; we do not own it
+    void attach(const Sample &s, uint8_t *block);
+    void detach();
+    bool isAttached() const { return memory != nullptr; }
+    uint8_t *getMemory() const { return memory; }
+
+    /*
+     * Audio thread. Make frames [lo, hi) readable, decoding what we don't already hold.
+     * False if the range is wider than the window can ever hold.
+     */
+    bool prepare(int64_t lo, int64_t hi, bool forward);
+    int64_t start() const { return windowStart; }
+    void *channelData(int c) const
+    {
+        return memory + c * channelBytes + dsp::samplePadding * elementSize;
+    }
+
+  private:
+    const CompressedFrames *frames{nullptr};
+    uint8_t *memory{nullptr};
+    size_t elementSize{sizeof(int16_t)};
+    bool asFloat{false};
+    int channels{1};
+    int64_t windowStart{0}, windowEnd{0}; // empty while equal
+};
+} // namespace scxt::sample
+
+#endif // SHORTCIRCUITXT_COMPRESSED_PLAYBACK_H
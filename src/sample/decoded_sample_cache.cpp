@@ -0,0 +1,216 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "decoded_sample_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "dsp/resampling.h"
+
+namespace scxt::sample
+{
+DecodedSampleCache::DecodedSampleCache(const fs::path &d, uint64_t mx)
+    : directory(d), maximumSizeInBytes(mx)
+{
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec)
+        SCLOG("Unable to create decoded sample cache at " << directory.u8string());
+    scanDirectory();
+}
+
+void DecodedSampleCache::scanDirectory()
+{
+    struct Found
+    {
+        std::string md5;
+        uint64_t size;
+        fs::file_time_type lastUsed;
+    };
+    std::vector<Found> found;
+
+    std::error_code ec;
+    for (auto &de : fs::directory_iterator(directory, ec))
+    {
+        if (de.path().extension() != ".scpcm")
+            continue;
+        auto sz = fs::file_size(de.path(), ec);
+        if (ec)
+            continue;
+        auto lu = fs::last_write_time(de.path(), ec);
+        if (ec)
+            continue;
+        found.push_back({de.path().stem().u8string(), sz, lu});
+    }
+
+    std::sort(found.begin(), found.end(),
+              [](const auto &a, const auto &b) { return a.lastUsed > b.lastUsed; });
+
+    std::lock_guard<std::mutex> g(indexMutex);
+    for (const auto &f : found)
+    {
+        lru.push_back(f.md5);
+        index[f.md5] = {f.size, std::prev(lru.end())};
+        totalSize += f.size;
+    }
+}
+
+void DecodedSampleCache::markUsed(const std::string &md5, uint64_t size)
+{
+    auto it = index.find(md5);
+    if (it == index.end())
+    {
+        lru.push_front(md5);
+        index[md5] = {size, lru.begin()};
+        totalSize += size;
+        return;
+    }
+    lru.splice(lru.begin(), lru, it->second.lruPosition);
+    totalSize = totalSize - it->second.size + size;
+    it->second.size = size;
+}
+
+fs::path DecodedSampleCache::pathFor(const std::string &md5) const
+{
+    return directory / (md5 + ".scpcm");
+}
+
+bool DecodedSampleCache::store(const std::string &md5, const Header &hIn,
+                               void *const channelData[2])
+{
+    if (md5.empty() || hIn.channels < 1 || hIn.channels > 2)
+        return false;
+
+    auto h = hIn;
+    auto channelBytes = ((uint64_t)h.sampleLength + 2 * dsp::samplePadding) * h.bytesPerSample;
+    h.channelStride = (channelBytes + blockAlignment - 1) / blockAlignment * blockAlignment;
+
+    if (h.channelStride * h.channels + blockAlignment > maximumSizeInBytes)
+        return false;
+
+    // Write to a name unique to this thread and then move it into place, so a
+    // concurrent fetch never sees a partial entry
+    auto target = pathFor(md5);
+    auto tmp = directory / (md5 + "." +
+                            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+                            ".tmp");
+    {
+        std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open())
+            return false;
+
+        std::vector<char> zeros(blockAlignment, 0);
+        ofs.write((const char *)&h, sizeof(h));
+        ofs.write(zeros.data(), blockAlignment - sizeof(h));
+        for (int c = 0; c < h.channels; ++c)
+        {
+            ofs.write((const char *)channelData[c], channelBytes);
+            ofs.write(zeros.data(), h.channelStride - channelBytes);
+        }
+        if (!ofs.good())
+        {
+            ofs.close();
+            std::error_code ec;
+            fs::remove(tmp, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, target, ec);
+    if (ec)
+    {
+        fs::remove(tmp, ec);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> g(indexMutex);
+    markUsed(md5, h.channelStride * h.channels + blockAlignment);
+    evictToSize();
+    return true;
+}
+
+std::unique_ptr<infrastructure::FileMapView> DecodedSampleCache::fetch(const std::string &md5,
+                                                                        Header &h)
+{
+    if (md5.empty())
+        return nullptr;
+
+    auto p = pathFor(md5);
+    std::error_code ec;
+    if (!fs::exists(p, ec))
+        return nullptr;
+
+    auto fmv = std::make_unique<infrastructure::FileMapView>(p);
+    if (!fmv->isMapped() || fmv->dataSize() < blockAlignment)
+        return nullptr;
+
+    memcpy(&h, fmv->data(), sizeof(h));
+    auto ref = Header();
+    auto channelBytes = ((uint64_t)h.sampleLength + 2 * dsp::samplePadding) * h.bytesPerSample;
+    if (memcmp(h.magic, ref.magic, sizeof(h.magic)) != 0 || h.version != formatVersion ||
+        h.channels < 1 || h.channels > 2 || h.channelStride < channelBytes ||
+        h.channelStride % blockAlignment != 0 ||
+        fmv->dataSize() < channelOffset(h, h.channels))
+    {
+        SCLOG("Ignoring invalid decoded sample cache entry " << p.u8string());
+        return nullptr;
+    }
+
+    // Mark it as recently used, on disk too so the order survives a restart
+    fs::last_write_time(p, fs::file_time_type::clock::now(), ec);
+    {
+        std::lock_guard<std::mutex> g(indexMutex);
+        markUsed(md5, fmv->dataSize());
+    }
+    return fmv;
+}
+
+void DecodedSampleCache::evictToSize()
+{
+    // Called with indexMutex held
+    auto it = lru.end();
+    while (totalSize > maximumSizeInBytes && it != lru.begin())
+    {
+        --it;
+        // A mapped entry may refuse to go on some platforms; it will on a later pass
+        std::error_code ec;
+        if (!fs::remove(pathFor(*it), ec) && fs::exists(pathFor(*it), ec))
+            continue;
+
+        auto ie = index.find(*it);
+        totalSize -= ie->second.size;
+        index.erase(ie);
+        it = lru.erase(it);
+    }
+}
+} // namespace scxt::sample
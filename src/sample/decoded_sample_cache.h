@@ -0,0 +1,119 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SAMPLE_DECODED_SAMPLE_CACHE_H
+#define SCXT_SRC_SAMPLE_DECODED_SAMPLE_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "utils.h"
+#include "infrastructure/filesystem_import.h"
+#include "infrastructure/file_map_view.h"
+
+namespace scxt::sample
+{
+/*
+ * An on disk cache of decoded FLAC and MP3 sample data, keyed by the md5 of the source
+ * file. Each entry is a header block followed by one block per channel containing
+ * exactly the padded buffer a Sample holds in sampleData (samplePadding zeros, the
+ * frames, then samplePadding more). Every block starts on a blockAlignment boundary so a
+ * mapped entry can be handed to the generator directly.
+ *
+ * Eviction is least recently used, bounded by maximumSizeInBytes. We scan the directory
+ * once at construction, ordering entries by modification time (which fetch bumps so the
+ * order survives restarts), and from then on keep the order and the running total in
+ * memory. Store and fetch are safe from multiple loader threads.
+ */
+struct DecodedSampleCache : MoveableOnly<DecodedSampleCache>
+{
+    static constexpr size_t blockAlignment{16384}; // the largest page size we ship on
+    /*
+     * Bump this whenever what we store for a given file changes. Versions 2 and 3 kept
+     * 24 bit FLAC packed at the 2^-23 scale, which version 4 puts back to float at 2^-24.
+     * Version 3 pads each channel by samplePadding where earlier versions used FIRoffset.
+     */
+    static constexpr uint32_t formatVersion{4};
+
+    struct Header
+    {
+        char magic[8]{'S', 'C', 'X', 'T', 'P', 'C', 'M', '\0'};
+        uint32_t version{formatVersion};
+        uint32_t sampleRate{0};
+        uint32_t sampleLength{0};
+        uint32_t bitDepth{0}; // a Sample::BitDepth
+        uint32_t bytesPerSample{0};
+        uint32_t channels{0};
+        uint64_t channelStride{0}; // bytes between channel blocks, a multiple of blockAlignment
+    };
+
+    DecodedSampleCache(const fs::path &directory, uint64_t maximumSizeInBytes);
+
+    /*
+     * Write an entry. channelData are the full padded sampleData buffers, each
+     * (sampleLength + 2 * samplePadding) * bytesPerSample long.
+     */
+    bool store(const std::string &md5, const Header &header, void *const channelData[2]);
+
+    /*
+     * Map an entry. On success header is filled in and channel c's padded buffer
+     * starts at data() + channelOffset(header, c).
+     */
+    std::unique_ptr<infrastructure::FileMapView> fetch(const std::string &md5, Header &header);
+
+    static size_t channelOffset(const Header &h, int channel)
+    {
+        return blockAlignment + channel * h.channelStride;
+    }
+
+  private:
+    fs::path pathFor(const std::string &md5) const;
+    void scanDirectory();
+    void markUsed(const std::string &md5, uint64_t size);
+    void evictToSize();
+
+    fs::path directory;
+    uint64_t maximumSizeInBytes;
+
+    // All guarded by indexMutex. lru runs from most to least recently used
+    struct IndexEntry
+    {
+        uint64_t size{0};
+        std::list<std::string>::iterator lruPosition;
+    };
+    std::mutex indexMutex;
+    std::list<std::string> lru;
+    std::unordered_map<std::string, IndexEntry> index;
+    uint64_t totalSize{0};
+};
+} // namespace scxt::sample
+
+#endif // SHORTCIRCUITXT_DECODED_SAMPLE_CACHE_H
@@ -63,6 +63,8 @@ class SampleFLACDecoder : public FLAC::Decoder::File
         }
         else if (bitDepth == 24 && sample->bitDepth == Sample::BD_F32)
         {
+            // Half the 2^-23 scale of the other 24 bit formats. Existing patches are
+            // balanced against it, so moving it needs its own change with a migration
             for (int c = 0; c < sample->channels; ++c)
             {
                 auto sdata = sample->GetSamplePtrF32(c);
@@ -34,9 +34,16 @@
 // #include "sampler_state.h"
 #include <cassert>
 #include <cstdint>
+#include <optional>
 
 namespace scxt::sample
 {
+static bool isLittleEndianHost()
+{
+    uint16_t v{1};
+    return *(uint8_t *)&v == 1;
+}
+
 // TODO: What is this
 size_t Sample::SaveWaveChunk(void *data)
 {
@@ -193,47 +200,110 @@ bool Sample::parse_riff_wave(void *data, size_t filesize, bool skip_riffchunk)
         return false;
     }
 
-    if (wh.wFormatTag == WAVE_FORMAT_PCM)
+    /*
+     * Mono 16 bit and float data is already laid out the way the generator wants it, so
+     * if we were asked to, note where it is and let load() keep the file mapping rather
+     * than decode a copy.
+     */
+    bool mapped{false};
+    if (mapWithoutCopy && channels == 1 && isLittleEndianHost() &&
+        ((wh.wFormatTag == WAVE_FORMAT_PCM && wh.wBitsPerSample == 16) ||
+         (wh.wFormatTag == WAVE_FORMAT_IEEE_FLOAT && wh.wBitsPerSample == 32)))
+    {
+        pendingMapping.active = true;
+        pendingMapping.offset = loaddata - (unsigned char *)data;
+        pendingMapping.bytes = WaveDataSize;
+        pendingMapping.bitDepth = wh.wBitsPerSample == 16 ? BD_I16 : BD_F32;
+        mapped = true;
+    }
+
+    /*
+     * If this sample is going to be streamed from disk we only decode the preload head
+     * here. Every format we can decode can also be streamed since the StreamingSource
+     * does the same conversions as the load_data_ functions below.
+     */
+    int32_t framesToLoad = WaveDataSamples;
+    if (!mapped && streamingConfiguration.enabled)
+    {
+        std::optional<StreamingSource::Encoding> encoding;
+        if (wh.wFormatTag == WAVE_FORMAT_PCM)
+        {
+            switch (wh.wBitsPerSample)
+            {
+            case 8:
+                encoding = StreamingSource::PCM_U8;
+                break;
+            case 16:
+                encoding = StreamingSource::PCM_I16;
+                break;
+            case 24:
+                encoding = StreamingSource::PCM_I24;
+                break;
+            case 32:
+                encoding = StreamingSource::PCM_I32;
+                break;
+            }
+        }
+        else if (wh.wFormatTag == WAVE_FORMAT_IEEE_FLOAT)
+        {
+            if (wh.wBitsPerSample == 32)
+                encoding = StreamingSource::FLOAT_F32;
+            else if (wh.wBitsPerSample == 64)
+                encoding = StreamingSource::FLOAT_F64;
+        }
+
+        if (encoding.has_value() && setupStreaming(*encoding, loaddata - (unsigned char *)data,
+                                                   wh.wBitsPerSample / 8))
+        {
+            framesToLoad = residentLength;
+        }
+    }
+
+    if (mapped)
+    {
+        // sampleData is set up by load() once it adopts the mapping
+    }
+    else if (wh.wFormatTag == WAVE_FORMAT_PCM)
     {
         if (wh.wBitsPerSample == 8)
         {
             if (channels == 2)
             {
-                load_data_ui8(0, loaddata, WaveDataSamples, 2);
-                load_data_ui8(1, loaddata + 1, WaveDataSamples, 2);
+                load_data_ui8(0, loaddata, framesToLoad, 2);
+                load_data_ui8(1, loaddata + 1, framesToLoad, 2);
             }
             else
-                load_data_ui8(0, loaddata, WaveDataSamples, 1);
+                load_data_ui8(0, loaddata, framesToLoad, 1);
         }
         else if (wh.wBitsPerSample == 16)
         {
             if (channels == 2)
             {
-                load_data_i16(0, loaddata, WaveDataSamples, 4);
-                load_data_i16(1, loaddata + 2, WaveDataSamples, 4);
+                load_data_i16(0, loaddata, framesToLoad, 4);
+                load_data_i16(1, loaddata + 2, framesToLoad, 4);
             }
             else
-                load_data_i16(0, loaddata, WaveDataSamples, 2);
+                load_data_i16(0, loaddata, framesToLoad, 2);
         }
         else if (wh.wBitsPerSample == 24)
         {
             if (channels == 2)
             {
-                load_data_i24(0, loaddata, WaveDataSamples, 6);
-                load_data_i24(1, loaddata + 3, WaveDataSamples, 6);
+                load_data_i24(0, loaddata, framesToLoad, 6);
+                load_data_i24(1, loaddata + 3, framesToLoad, 6);
             }
             else
-                load_data_i24(0, loaddata, WaveDataSamples, 3);
+                load_data_i24(0, loaddata, framesToLoad, 3);
         }
         else if (wh.wBitsPerSample == 32)
         {
             if (channels == 2)
             {
-                load_data_i32(0, loaddata, WaveDataSamples, 8);
-                load_data_i32(1, loaddata + 4, WaveDataSamples, 8);
+                load_data_i32(0, loaddata, framesToLoad, 8);
+                load_data_i32(1, loaddata + 4, framesToLoad, 8);
             }
             else
-                load_data_i32(0, loaddata, WaveDataSamples, 4);
+                load_data_i32(0, loaddata, framesToLoad, 4);
         }
         else
         {
@@ -248,21 +318,21 @@ bool Sample::parse_riff_wave(void *data, size_t filesize, bool skip_riffchunk)
         {
             if (channels == 2)
             {
-                load_data_f32(0, loaddata, WaveDataSamples, 8);
-                load_data_f32(1, loaddata + 4, WaveDataSamples, 8);
+                load_data_f32(0, loaddata, framesToLoad, 8);
+                load_data_f32(1, loaddata + 4, framesToLoad, 8);
             }
             else
-                load_data_f32(0, loaddata, WaveDataSamples, 4);
+                load_data_f32(0, loaddata, framesToLoad, 4);
         }
         else if (wh.wBitsPerSample == 64)
         {
             if (channels == 2)
             {
-                load_data_f64(0, loaddata, WaveDataSamples, 16);
-                load_data_f64(1, loaddata + 8, WaveDataSamples, 16);
+                load_data_f64(0, loaddata, framesToLoad, 16);
+                load_data_f64(1, loaddata + 8, framesToLoad, 16);
             }
             else
-                load_data_f64(0, loaddata, WaveDataSamples, 8);
+                load_data_f64(0, loaddata, framesToLoad, 8);
         }
         else
         {
@@ -0,0 +1,325 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "pcm_conversion.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "infrastructure/sse_include.h"
+
+namespace scxt::sample::pcm
+{
+namespace
+{
+/*
+ * Big conversions are cut into contiguous runs of frames, one per thread. Each run
+ * is a complete call to the kernel so the vector loops' tail handling keeps every read
+ * and write inside its own run. Threads which are already one of a set loading in
+ * parallel don't split, and nor does anything they call.
+ */
+static constexpr size_t minFramesPerThread{1 << 18};
+static constexpr size_t maxThreads{4};
+thread_local bool splitAcrossThreads{true};
+
+template <typename T, typename K>
+void convertInChunks(const uint8_t *src, size_t stride, size_t frames, T *dst, K kernel)
+{
+    auto nThreads = std::clamp(frames / minFramesPerThread, (size_t)1,
+                               std::min((size_t)std::max(std::thread::hardware_concurrency(), 1u),
+                                        maxThreads));
+    if (nThreads == 1 || !splitAcrossThreads)
+    {
+        kernel(src, stride, frames, dst);
+        return;
+    }
+
+    auto chunk = (frames + nThreads - 1) / nThreads;
+    std::vector<std::thread> pool;
+    for (size_t start = chunk; start < frames; start += chunk)
+    {
+        auto n = std::min(chunk, frames - start);
+        pool.emplace_back([=]() { kernel(src + start * stride, stride, n, dst + start); });
+    }
+    kernel(src, stride, chunk, dst);
+    for (auto &t : pool)
+        t.join();
+}
+
+// pshufb masks reversing the bytes of each 16 and 32 bit lane
+inline __m128i byteSwap16()
+{
+    return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+}
+inline __m128i byteSwap32()
+{
+    return _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+}
+
+/*
+ * pshufb mask moving the 3 byte samples at byte offsets off[] of a register into the top
+ * three bytes of each 32 bit lane, so an arithmetic shift right by 8 sign extends them.
+ * Lanes with a negative offset come out zero.
+ */
+inline __m128i i24ToLanes(const int (&off)[4], bool bigEndian)
+{
+    alignas(16) int8_t m[16];
+    for (int l = 0; l < 4; ++l)
+    {
+        m[l * 4] = -1;
+        for (int b = 0; b < 3; ++b)
+            m[l * 4 + 1 + b] = off[l] < 0 ? -1 : (int8_t)(off[l] + (bigEndian ? 2 - b : b));
+    }
+    return _mm_load_si128((const __m128i *)m);
+}
+
+// As above but packing the samples, little endian, into the low twelve bytes
+inline __m128i i24ToPacked(const int (&off)[4], bool bigEndian)
+{
+    alignas(16) int8_t m[16];
+    for (int k = 0; k < 4; ++k)
+        for (int b = 0; b < 3; ++b)
+            m[k * 3 + b] = off[k] < 0 ? -1 : (int8_t)(off[k] + (bigEndian ? 2 - b : b));
+    for (int b = 12; b < 16; ++b)
+        m[b] = -1;
+    return _mm_load_si128((const __m128i *)m);
+}
+
+/*
+ * Four 24 bit samples, either four mono ones in one load or two stereo frames from each
+ * of two loads twelve bytes apart. Callers keep i + 6 <= frames so that neither the 16
+ * byte reads nor a 16 byte packed write run past the end of their run.
+ */
+constexpr int mono24[4]{0, 3, 6, 9}, stereoLo24[4]{0, 6, -1, -1}, stereoHi24[4]{-1, -1, 0, 6};
+
+inline __m128i load24(const uint8_t *p, size_t stride, __m128i mlo, __m128i mhi)
+{
+    auto v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p), mlo);
+    if (stride == 6)
+        v = _mm_or_si128(v, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 12)), mhi));
+    return v;
+}
+
+template <bool bigEndian>
+void i16Kernel(const uint8_t *src, size_t stride, size_t frames, int16_t *dst)
+{
+    size_t i{0};
+    if (stride == 2)
+    {
+        if (!bigEndian)
+        {
+            memcpy(dst, src, frames * sizeof(int16_t));
+            return;
+        }
+        auto swap = byteSwap16();
+        for (; i + 8 <= frames; i += 8)
+        {
+            auto v = _mm_loadu_si128((const __m128i *)(src + i * 2));
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_shuffle_epi8(v, swap));
+        }
+    }
+    else if (stride == 4)
+    {
+        // Keep the low half of each 32 bit frame, sign extended, then pack back to 16
+        auto swap = byteSwap16();
+        for (; i + 9 <= frames; i += 8)
+        {
+            auto a = _mm_loadu_si128((const __m128i *)(src + i * 4));
+            auto b = _mm_loadu_si128((const __m128i *)(src + i * 4 + 16));
+            if (bigEndian)
+            {
+                a = _mm_shuffle_epi8(a, swap);
+                b = _mm_shuffle_epi8(b, swap);
+            }
+            a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+            b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(a, b));
+        }
+    }
+
+    for (; i < frames; ++i)
+    {
+        auto *c = src + i * stride;
+        dst[i] = bigEndian ? (int16_t)((c[0] << 8) | c[1]) : (int16_t)((c[1] << 8) | c[0]);
+    }
+}
+
+template <bool bigEndian>
+void i24ToF32Kernel(const uint8_t *src, size_t stride, size_t frames, float *dst)
+{
+    size_t i{0};
+    if (stride == 3 || stride == 6)
+    {
+        auto mlo = i24ToLanes(stride == 3 ? mono24 : stereoLo24, bigEndian);
+        auto mhi = i24ToLanes(stereoHi24, bigEndian);
+        auto scale = _mm_set1_ps(0.00000011920928955078f);
+        for (; i + 6 <= frames; i += 4)
+        {
+            auto v = _mm_srai_epi32(load24(src + i * stride, stride, mlo, mhi), 8);
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+        }
+    }
+
+    for (; i < frames; ++i)
+    {
+        auto *c = src + i * stride;
+        int value = bigEndian ? (c[0] << 16) | (c[1] << 8) | c[2]
+                              : (c[2] << 16) | (c[1] << 8) | c[0];
+        value -= (value & 0x800000) << 1;
+        dst[i] = 0.00000011920928955078f * float(value);
+    }
+}
+
+template <bool bigEndian>
+void i24ToPackedKernel(const uint8_t *src, size_t stride, size_t frames, dsp::PackedI24 *dst)
+{
+    size_t i{0};
+    if (stride == 3 && !bigEndian)
+    {
+        memcpy(dst, src, frames * sizeof(dsp::PackedI24));
+        return;
+    }
+    if (stride == 3 || stride == 6)
+    {
+        auto mlo = i24ToPacked(stride == 3 ? mono24 : stereoLo24, bigEndian);
+        auto mhi = i24ToPacked(stereoHi24, bigEndian);
+        for (; i + 6 <= frames; i += 4)
+            _mm_storeu_si128((__m128i *)(dst + i), load24(src + i * stride, stride, mlo, mhi));
+    }
+
+    for (; i < frames; ++i)
+    {
+        auto *c = src + i * stride;
+        dst[i] = bigEndian ? dsp::PackedI24{{c[2], c[1], c[0]}}
+                           : dsp::PackedI24{{c[0], c[1], c[2]}};
+    }
+}
+
+// Four 32 bit values, either one mono load or the even lanes of two stereo loads
+inline __m128i load32(const uint8_t *p, size_t stride)
+{
+    auto a = _mm_loadu_si128((const __m128i *)p);
+    if (stride == 4)
+        return a;
+    auto b = _mm_loadu_si128((const __m128i *)(p + 16));
+    return _mm_castps_si128(
+        _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+template <bool bigEndian>
+void i32ToF32Kernel(const uint8_t *src, size_t stride, size_t frames, float *dst)
+{
+    size_t i{0};
+    if (stride == 4 || stride == 8)
+    {
+        auto swap = byteSwap32();
+        auto scale = _mm_set1_ps(4.6566128730772E-10f);
+        for (; i + 5 <= frames; i += 4)
+        {
+            auto v = load32(src + i * stride, stride);
+            if (bigEndian)
+                v = _mm_shuffle_epi8(v, swap);
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+        }
+    }
+
+    for (; i < frames; ++i)
+    {
+        auto *c = src + i * stride;
+        auto x = bigEndian ? (int32_t)(((uint32_t)c[0] << 24) | (c[1] << 16) | (c[2] << 8) | c[3])
+                           : (int32_t)(((uint32_t)c[3] << 24) | (c[2] << 16) | (c[1] << 8) | c[0]);
+        dst[i] = (4.6566128730772E-10f) * (float)x;
+    }
+}
+
+void f32Kernel(const uint8_t *src, size_t stride, size_t frames, float *dst)
+{
+    size_t i{0};
+    if (stride == 4)
+    {
+        memcpy(dst, src, frames * sizeof(float));
+        return;
+    }
+    if (stride == 8)
+    {
+        for (; i + 5 <= frames; i += 4)
+            _mm_storeu_ps(dst + i, _mm_castsi128_ps(load32(src + i * stride, stride)));
+    }
+
+    for (; i < frames; ++i)
+        memcpy(dst + i, src + i * stride, sizeof(float));
+}
+} // namespace
+
+SingleThreadedScope::SingleThreadedScope() : previous(splitAcrossThreads)
+{
+    splitAcrossThreads = false;
+}
+SingleThreadedScope::~SingleThreadedScope() { splitAcrossThreads = previous; }
+
+void i16LEToI16(const uint8_t *src, size_t stride, size_t frames, int16_t *dst)
+{
+    convertInChunks(src, stride, frames, dst, i16Kernel<false>);
+}
+void i16BEToI16(const uint8_t *src, size_t stride, size_t frames, int16_t *dst)
+{
+    convertInChunks(src, stride, frames, dst, i16Kernel<true>);
+}
+
+void i24LEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst)
+{
+    convertInChunks(src, stride, frames, dst, i24ToF32Kernel<false>);
+}
+void i24BEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst)
+{
+    convertInChunks(src, stride, frames, dst, i24ToF32Kernel<true>);
+}
+void i24LEToPacked(const uint8_t *src, size_t stride, size_t frames, dsp::PackedI24 *dst)
+{
+    convertInChunks(src, stride, frames, dst, i24ToPackedKernel<false>);
+}
+void i24BEToPacked(const uint8_t *src, size_t stride, size_t frames, dsp::PackedI24 *dst)
+{
+    convertInChunks(src, stride, frames, dst, i24ToPackedKernel<true>);
+}
+
+void i32LEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst)
+{
+    convertInChunks(src, stride, frames, dst, i32ToF32Kernel<false>);
+}
+void i32BEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst)
+{
+    convertInChunks(src, stride, frames, dst, i32ToF32Kernel<true>);
+}
+
+void f32LEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst)
+{
+    convertInChunks(src, stride, frames, dst, f32Kernel);
+}
+} // namespace scxt::sample::pcm
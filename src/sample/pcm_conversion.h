@@ -0,0 +1,72 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SAMPLE_PCM_CONVERSION_H
+#define SCXT_SRC_SAMPLE_PCM_CONVERSION_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "dsp/sample_formats.h"
+
+/*
+ * Deinterleave and convert kernels for the Sample::load_data_ functions. Each reads
+ * `frames` samples `stride` bytes apart starting at src (so a stereo file's right
+ * channel is src + bytesPerSample with stride 2 * bytesPerSample) and writes them
+ * contiguously to dst. The packed mono and stereo strides run vectorised and anything
+ * else takes a scalar loop. Conversions large enough to matter are split across a few
+ * threads, unless the calling thread holds a SingleThreadedScope.
+ *
+ * These assume a little endian host, which every platform we build for is.
+ */
+namespace scxt::sample::pcm
+{
+// While one of these lives conversions on this thread stay on it. Loader workers hold one.
+struct SingleThreadedScope
+{
+    SingleThreadedScope();
+    ~SingleThreadedScope();
+
+  private:
+    bool previous;
+};
+
+void i16LEToI16(const uint8_t *src, size_t stride, size_t frames, int16_t *dst);
+void i16BEToI16(const uint8_t *src, size_t stride, size_t frames, int16_t *dst);
+
+void i24LEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst);
+void i24BEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst);
+void i24LEToPacked(const uint8_t *src, size_t stride, size_t frames, dsp::PackedI24 *dst);
+void i24BEToPacked(const uint8_t *src, size_t stride, size_t frames, dsp::PackedI24 *dst);
+
+void i32LEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst);
+void i32BEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst);
+
+void f32LEToF32(const uint8_t *src, size_t stride, size_t frames, float *dst);
+} // namespace scxt::sample::pcm
+
+#endif // SHORTCIRCUITXT_PCM_CONVERSION_H
@@ -27,10 +27,13 @@
 
 #include <sstream>
 #include "sst/basic-blocks/mechanics/endian-ops.h"
+#include "sst/filters/HalfRateFilter.h"
 #include "infrastructure/file_map_view.h"
 #include "infrastructure/md5support.h"
 #include "dsp/resampling.h"
 #include "sample.h"
+#include "decoded_sample_cache.h"
+#include "pcm_conversion.h"
 
 namespace scxt::sample
 {
@@ -40,6 +43,17 @@ using namespace sst::basic_blocks::mechanics;
 
 Sample::~Sample()
 {
+    for (auto &lev : decimatedLevels)
+    {
+        for (auto &d : lev.data)
+            if (d)
+                free(d);
+    }
+
+    // A mapped sample points into mappedFile, which cleans up after itself
+    if (mappedFile)
+        return;
+
     if (sampleData[0])
         free(sampleData[0]);
     if (sampleData[1])
@@ -51,21 +65,26 @@ bool Sample::load(const fs::path &path)
     if (!fs::exists(path))
         return false;
 
-    md5Sum = infrastructure::createMD5SumFromFile(path);
+    md5Sum = infrastructure::createMD5SumFromFile(path, md5Cache);
 
     // If you add a type here add it in Browser::isLoadableFile also to stay in sync
     if (extensionMatches(path, ".wav"))
     {
-        auto fmv = std::make_unique<infrastructure::FileMapView>(path);
+        auto fmv = std::make_unique<infrastructure::FileMapView>(path, mapWithoutCopy);
         auto data = fmv->data();
         auto datasize = fmv->dataSize();
 
         clear_data(); // clear to a more predictable state
 
+        // the streaming setup in parse_riff_wave needs to know where to re-open the file
+        mFileName = path;
         bool r = parse_riff_wave(data, datasize);
         if (!r)
             return false;
 
+        if (pendingMapping.active && !adoptMapping(fmv))
+            return false;
+
         sample_loaded = true;
         mFileName = path;
         displayName = fmt::format("{}", path.filename().u8string());
@@ -74,8 +93,11 @@ bool Sample::load(const fs::path &path)
     }
     else if (extensionMatches(path, ".flac"))
     {
-        if (parseFlac(path))
+        auto fromCache = loadFromDecodedCache();
+        if (fromCache || parseFlac(path))
         {
+            if (!fromCache)
+                storeToDecodedCache();
             sample_loaded = true;
             type = FLAC_FILE;
             mFileName = path;
@@ -85,8 +107,11 @@ bool Sample::load(const fs::path &path)
     }
     else if (extensionMatches(path, ".mp3"))
     {
-        if (parseMP3(path))
+        auto fromCache = loadFromDecodedCache();
+        if (fromCache || parseMP3(path))
         {
+            if (!fromCache)
+                storeToDecodedCache();
             sample_loaded = true;
             type = MP3_FILE;
             mFileName = path;
@@ -195,6 +220,180 @@ bool Sample::loadFromSF2(const fs::path &p, sf2::File *f, int presetNum, int ins
     return false;
 }
 
+bool Sample::setupStreaming(StreamingSource::Encoding enc, size_t dataOffset,
+                            uint8_t bytesPerSample)
+{
+    auto decodedBytes = (size_t)sample_length * channels *
+                        (enc == StreamingSource::PCM_U8 || enc == StreamingSource::PCM_I16 ? 2 : 4);
+
+    if (!streamingConfiguration.enabled || mFileName.empty() ||
+        decodedBytes < streamingConfiguration.minimumSizeInBytes ||
+        sample_length <= streamingConfiguration.preloadFrames)
+        return false;
+
+    auto src = std::make_unique<StreamingSource>();
+    src->encoding = enc;
+    src->path = mFileName;
+    src->dataOffset = dataOffset;
+    src->channels = channels;
+    src->bytesPerSample = bytesPerSample;
+    src->totalFrames = sample_length;
+
+    streamingSource = std::move(src);
+    isStreamed = true;
+    residentLength = streamingConfiguration.preloadFrames;
+    return true;
+}
+
+bool Sample::compressResidentData()
+{
+    if (isStreamed || isCompressed() || mappedFile || channels == 0 || channels > 2 ||
+        sample_length <= streamingConfiguration.preloadFrames ||
+        getDataSize() < streamingConfiguration.minimumSizeInBytes)
+        return false;
+
+    auto frames = std::make_unique<CompressedFrames>();
+    frames->channels = channels;
+    frames->totalFrames = sample_length;
+
+    switch (bitDepth)
+    {
+    case BD_I16:
+        frames->bitsPerSample = 16;
+        for (int c = 0; c < channels; ++c)
+        {
+            auto *d = GetSamplePtrI16(c);
+            frames->encodeChannel(c, [d](auto i) { return (int32_t)d[i]; });
+        }
+        break;
+    case BD_I24:
+        frames->bitsPerSample = 24;
+        for (int c = 0; c < channels; ++c)
+        {
+            auto *d = GetSamplePtrI24(c);
+            frames->encodeChannel(c, [d](auto i) {
+                const auto &p = d[i];
+                int value = (p.b[2] << 16) | (p.b[1] << 8) | p.b[0];
+                return value - ((value & 0x800000) << 1);
+            });
+        }
+        break;
+    case BD_I8:
+        frames->bitsPerSample = 8;
+        for (int c = 0; c < channels; ++c)
+        {
+            auto *d = GetSamplePtrI8(c);
+            frames->encodeChannel(c, [d](auto i) { return (int32_t)d[i]; });
+        }
+        break;
+    default:
+        // Float data doesn't compress losslessly with a fixed predictor
+        return false;
+    }
+
+    auto uncompressed = getDataSize();
+
+    // The voices' decode windows are I16 or F32, so the head has to match them
+    auto head = streamingConfiguration.preloadFrames;
+    auto asFloat = frames->bitsPerSample > 16;
+    std::vector<int32_t> scratch(CompressedFrames::blockFrames);
+    for (int c = 0; c < channels; ++c)
+    {
+        if (asFloat)
+            allocateF32(c, head);
+        else
+            allocateI16(c, head);
+        auto *dest = asFloat ? (void *)GetSamplePtrF32(c) : (void *)GetSamplePtrI16(c);
+        frames->decodeFrames(c, 0, head, asFloat, dest, scratch.data());
+    }
+
+    SCLOG("Compressed " << displayName << " from " << uncompressed << " to "
+                        << frames->compressedBytes() << " bytes plus a "
+                        << (size_t)head * channels * bitDepthByteSize(bitDepth) << " byte head");
+
+    compressedFrames = std::move(frames);
+    residentLength = head;
+    return true;
+}
+
+bool Sample::loadFromDecodedCache()
+{
+    if (!decodedCache)
+        return false;
+
+    DecodedSampleCache::Header h;
+    auto fmv = decodedCache->fetch(md5Sum, h);
+    if (!fmv)
+        return false;
+
+    auto bd = (BitDepth)h.bitDepth;
+    if (bd > BD_I8 || h.bytesPerSample != bitDepthByteSize(bd))
+        return false;
+
+    clear_data();
+    sample_rate = h.sampleRate;
+    sample_length = h.sampleLength;
+    channels = h.channels;
+    bitDepth = bd;
+
+    auto *base = (uint8_t *)fmv->data();
+    for (int c = 0; c < channels; ++c)
+        sampleData[c] = base + DecodedSampleCache::channelOffset(h, c);
+    mappedFile = std::move(fmv);
+    return true;
+}
+
+void Sample::storeToDecodedCache()
+{
+    if (!decodedCache || mappedFile || md5Sum.empty())
+        return;
+
+    DecodedSampleCache::Header h;
+    h.sampleRate = sample_rate;
+    h.sampleLength = sample_length;
+    h.bitDepth = bitDepth;
+    h.bytesPerSample = bitDepthByteSize(bitDepth);
+    h.channels = channels;
+    if (!decodedCache->store(md5Sum, h, sampleData))
+        SCLOG("Unable to cache decoded data for " << mFileName.u8string());
+}
+
+bool Sample::adoptMapping(std::unique_ptr<infrastructure::FileMapView> &fmv)
+{
+    pendingMapping.active = false;
+
+    auto bytesPerSample = (size_t)bitDepthByteSize(pendingMapping.bitDepth);
+    auto padBytes = scxt::dsp::samplePadding * bytesPerSample;
+    auto *base = (uint8_t *)fmv->data();
+    auto start = pendingMapping.offset;
+    auto end = start + pendingMapping.bytes;
+
+    // We need an aligned start and room for samplePadding samples either side which
+    // we can zero in our private view. The front comes out of the wav header, so a
+    // file with too short a header gets decoded instead.
+    auto canMap = fmv->isCopyOnWrite() && start >= padBytes && start % bytesPerSample == 0 &&
+                  end + padBytes <= fmv->readableSize();
+    if (canMap)
+    {
+        memset(base + start - padBytes, 0, padBytes);
+        // past the end of the file the page already reads as zero
+        auto zeroEnd = std::min(end + padBytes, fmv->dataSize());
+        if (zeroEnd > end)
+            memset(base + end, 0, zeroEnd - end);
+
+        bitDepth = pendingMapping.bitDepth;
+        sampleData[0] = base + start - padBytes;
+        sampleData[1] = nullptr;
+        mappedFile = std::move(fmv);
+        return true;
+    }
+
+    // Otherwise decode a copy like any other wav
+    if (pendingMapping.bitDepth == BD_I16)
+        return load_data_i16(0, base + start, sample_length, bytesPerSample);
+    return load_data_f32(0, base + start, sample_length, bytesPerSample);
+}
+
 // TODO: Rename these
 short *Sample::GetSamplePtrI16(int Channel)
 {
@@ -202,7 +401,7 @@ short *Sample::GetSamplePtrI16(int Channel)
         return nullptr;
     if (!sampleData[Channel])
         return nullptr;
-    return &((short *)sampleData[Channel])[scxt::dsp::FIRoffset];
+    return &((short *)sampleData[Channel])[scxt::dsp::samplePadding];
 }
 float *Sample::GetSamplePtrF32(int Channel)
 {
@@ -210,7 +409,104 @@ float *Sample::GetSamplePtrF32(int Channel)
         return nullptr;
     if (!sampleData[Channel])
         return nullptr;
-    return &((float *)sampleData[Channel])[scxt::dsp::FIRoffset];
+    return &((float *)sampleData[Channel])[scxt::dsp::samplePadding];
+}
+dsp::PackedI24 *Sample::GetSamplePtrI24(int Channel)
+{
+    if (bitDepth != BD_I24)
+        return nullptr;
+    if (!sampleData[Channel])
+        return nullptr;
+    return &((dsp::PackedI24 *)sampleData[Channel])[scxt::dsp::samplePadding];
+}
+int8_t *Sample::GetSamplePtrI8(int Channel)
+{
+    if (bitDepth != BD_I8)
+        return nullptr;
+    if (!sampleData[Channel])
+        return nullptr;
+    return &((int8_t *)sampleData[Channel])[scxt::dsp::samplePadding];
+}
+
+float *Sample::getDecimatedSamplePtr(int level, int channel)
+{
+    if (level >= numDecimatedLevels || !decimatedLevels[level].data[channel])
+        return nullptr;
+    return &decimatedLevels[level].data[channel][scxt::dsp::samplePadding];
+}
+
+void Sample::buildDecimatedLevels()
+{
+    if (isStreamed || numDecimatedLevels > 0 || sample_length == 0 || channels > 2)
+        return;
+
+    // The filter state carries across chunks so this only bounds the scratch buffers
+    static constexpr uint32_t chunk{64};
+    sst::filters::HalfRate::HalfRateFilter filter(6, true);
+
+    auto readSource = [this](int level, int c, uint32_t i) -> float {
+        if (level > 0)
+            return decimatedLevels[level - 1].data[c][scxt::dsp::samplePadding + i];
+        switch (bitDepth)
+        {
+        case BD_I16:
+            return GetSamplePtrI16(c)[i] * (1.f / 32768.f);
+        case BD_I24:
+            return dsp::normalizedI24(GetSamplePtrI24(c)[i]);
+        case BD_I8:
+            return dsp::normalizedI8(GetSamplePtrI8(c)[i]);
+        default:
+            return GetSamplePtrF32(c)[i];
+        }
+    };
+
+    auto sourceLength = sample_length;
+    for (int l = 0; l < maxDecimatedLevels; ++l)
+    {
+        auto &lev = decimatedLevels[l];
+        lev.length = (sourceLength + 1) / 2;
+        for (int c = 0; c < channels; ++c)
+        {
+            lev.data[c] =
+                (float *)malloc(sizeof(float) * (lev.length + 2 * scxt::dsp::samplePadding));
+            if (!lev.data[c])
+            {
+                SCLOG("Unable to allocate decimated level " << l << " for " << displayName);
+                return;
+            }
+            memset(lev.data[c], 0, scxt::dsp::samplePadding * sizeof(float));
+            memset(lev.data[c] + lev.length + scxt::dsp::samplePadding, 0,
+                   scxt::dsp::samplePadding * sizeof(float));
+        }
+
+        filter.reset();
+        float in alignas(16)[2][chunk];
+        for (uint32_t s = 0; s < sourceLength; s += chunk)
+        {
+            auto n = std::min(chunk, sourceLength - s);
+            for (uint32_t i = 0; i < chunk; ++i)
+            {
+                in[0][i] = i < n ? readSource(l, 0, s + i) : 0.f;
+                in[1][i] = i < n && channels > 1 ? readSource(l, 1, s + i) : 0.f;
+            }
+            filter.process_block_D2(in[0], in[1], chunk);
+
+            auto outN = std::min(chunk >> 1, lev.length - (s >> 1));
+            for (int c = 0; c < channels; ++c)
+                memcpy(lev.data[c] + scxt::dsp::samplePadding + (s >> 1), in[c],
+                       outN * sizeof(float));
+        }
+        numDecimatedLevels = l + 1;
+        sourceLength = lev.length;
+    }
+}
+
+size_t Sample::getDecimatedDataSize() const
+{
+    size_t res{0};
+    for (int l = 0; l < numDecimatedLevels; ++l)
+        res += decimatedLevels[l].length * sizeof(float) * channels;
+    return res;
 }
 
 // TODO: What the heck is this doing?
@@ -218,7 +514,7 @@ bool Sample::allocateI16(int Channel, int Samples)
 {
     // int samplesizewithmargin = Samples + 2*scxt::dsp::FIRipol_N + BLOCK_SIZE +
     // scxt::dsp::FIRoffset;
-    int samplesizewithmargin = Samples + scxt::dsp::FIRipol_N;
+    int samplesizewithmargin = Samples + 2 * scxt::dsp::samplePadding;
     if (sampleData[Channel])
         free(sampleData[Channel]);
     sampleData[Channel] = malloc(sizeof(short) * samplesizewithmargin);
@@ -227,15 +523,15 @@ bool Sample::allocateI16(int Channel, int Samples)
     bitDepth = BD_I16;
 
     // clear pre/post zero area
-    memset(sampleData[Channel], 0, scxt::dsp::FIRoffset * sizeof(short));
-    memset((char *)sampleData[Channel] + (Samples + scxt::dsp::FIRoffset) * sizeof(short), 0,
-           scxt::dsp::FIRoffset * sizeof(short));
+    memset(sampleData[Channel], 0, scxt::dsp::samplePadding * sizeof(short));
+    memset((char *)sampleData[Channel] + (Samples + scxt::dsp::samplePadding) * sizeof(short),
+           0, scxt::dsp::samplePadding * sizeof(short));
 
     return true;
 }
 bool Sample::allocateF32(int Channel, int Samples)
 {
-    int samplesizewithmargin = Samples + scxt::dsp::FIRipol_N;
+    int samplesizewithmargin = Samples + 2 * scxt::dsp::samplePadding;
     if (sampleData[Channel])
         free(sampleData[Channel]);
     sampleData[Channel] = malloc(sizeof(float) * samplesizewithmargin);
@@ -244,33 +540,98 @@ bool Sample::allocateF32(int Channel, int Samples)
     bitDepth = BD_F32;
 
     // clear pre/post zero area
-    memset(sampleData[Channel], 0, scxt::dsp::FIRoffset * sizeof(float));
-    memset((char *)sampleData[Channel] + (Samples + scxt::dsp::FIRoffset) * sizeof(float), 0,
-           scxt::dsp::FIRoffset * sizeof(float));
+    memset(sampleData[Channel], 0, scxt::dsp::samplePadding * sizeof(float));
+    memset((char *)sampleData[Channel] + (Samples + scxt::dsp::samplePadding) * sizeof(float),
+           0, scxt::dsp::samplePadding * sizeof(float));
+
+    return true;
+}
+
+bool Sample::allocateI24(int Channel, int Samples)
+{
+    int samplesizewithmargin = Samples + 2 * scxt::dsp::samplePadding;
+    if (sampleData[Channel])
+        free(sampleData[Channel]);
+    sampleData[Channel] = malloc(sizeof(dsp::PackedI24) * samplesizewithmargin);
+    if (!sampleData[Channel])
+        return false;
+    bitDepth = BD_I24;
+
+    // clear pre/post zero area
+    memset(sampleData[Channel], 0, scxt::dsp::samplePadding * sizeof(dsp::PackedI24));
+    memset((char *)sampleData[Channel] +
+               (Samples + scxt::dsp::samplePadding) * sizeof(dsp::PackedI24),
+           0, scxt::dsp::samplePadding * sizeof(dsp::PackedI24));
 
     return true;
 }
 
+bool Sample::allocateI8(int Channel, int Samples)
+{
+    int samplesizewithmargin = Samples + 2 * scxt::dsp::samplePadding;
+    if (sampleData[Channel])
+        free(sampleData[Channel]);
+    sampleData[Channel] = malloc(sizeof(int8_t) * samplesizewithmargin);
+    if (!sampleData[Channel])
+        return false;
+    bitDepth = BD_I8;
+
+    // clear pre/post zero area
+    memset(sampleData[Channel], 0, scxt::dsp::samplePadding * sizeof(int8_t));
+    memset((char *)sampleData[Channel] + (Samples + scxt::dsp::samplePadding) * sizeof(int8_t),
+           0, scxt::dsp::samplePadding * sizeof(int8_t));
+
+    return true;
+}
+
+/*
+ * 8 and 24 bit data stays at its own width in memory. A streamed sample's windows are
+ * always I16 or F32 though, so if we are streaming we widen the resident head to match.
+ */
 bool Sample::load_data_ui8(int channel, void *data, unsigned int samplesize, unsigned int stride)
 {
-    allocateI16(channel, samplesize);
-    short *sampledata = GetSamplePtrI16(channel);
+    if (isStreamed)
+    {
+        allocateI16(channel, samplesize);
+        short *sampledata = GetSamplePtrI16(channel);
+
+        for (int i = 0; i < samplesize; i++)
+        {
+            sampledata[i] = (((short)*((unsigned char *)data + i * stride)) - 128) << 8;
+        }
+        return true;
+    }
+
+    allocateI8(channel, samplesize);
+    int8_t *sampledata = GetSamplePtrI8(channel);
 
     for (int i = 0; i < samplesize; i++)
     {
-        sampledata[i] = (((short)*((unsigned char *)data + i * stride)) - 128) << 8;
+        sampledata[i] = (int8_t)(*((unsigned char *)data + i * stride) - 128);
     }
     return true;
 }
 
 bool Sample::load_data_i8(int channel, void *data, unsigned int samplesize, unsigned int stride)
 {
-    allocateI16(channel, samplesize);
-    short *sampledata = GetSamplePtrI16(channel);
+    if (isStreamed)
+    {
+        allocateI16(channel, samplesize);
+        short *sampledata = GetSamplePtrI16(channel);
+
+        for (int i = 0; i < samplesize; i++)
+        {
+            sampledata[i] = ((short)*((char *)data + i * stride)) << 8;
+        }
+        return true;
+    }
+
+    allocateI8(channel, samplesize);
+    int8_t *sampledata = GetSamplePtrI8(channel);
 
     for (int i = 0; i < samplesize; i++)
     {
-        sampledata[i] = ((short)*((char *)data + i * stride)) << 8;
+        sampledata[i] = *((int8_t *)data + i * stride);
     }
     return true;
 }
@@ -278,93 +639,62 @@ bool Sample::load_data_i8(int channel, void *data, unsigned int samplesize, unsi
 bool Sample::load_data_i16(int channel, void *data, unsigned int samplesize, unsigned int stride)
 {
     allocateI16(channel, samplesize);
-    short *sampledata = GetSamplePtrI16(channel);
-
-    for (int i = 0; i < samplesize; i++)
-    {
-        sampledata[i] = endian_read_int16LE(*(short *)((char *)data + i * stride));
-    }
+    pcm::i16LEToI16((const uint8_t *)data, stride, samplesize, GetSamplePtrI16(channel));
     return true;
 }
 
 bool Sample::load_data_i16BE(int channel, void *data, unsigned int samplesize, unsigned int stride)
 {
     allocateI16(channel, samplesize);
-    short *sampledata = GetSamplePtrI16(channel);
-
-    for (int i = 0; i < samplesize; i++)
-    {
-        sampledata[i] = endian_read_int16BE(*(short *)((char *)data + i * stride));
-    }
+    pcm::i16BEToI16((const uint8_t *)data, stride, samplesize, GetSamplePtrI16(channel));
     return true;
 }
 bool Sample::load_data_i32(int channel, void *data, unsigned int samplesize, unsigned int stride)
 {
     allocateF32(channel, samplesize);
-    float *sampledata = GetSamplePtrF32(channel);
-
-    for (int i = 0; i < samplesize; i++)
-    {
-        int x = endian_read_int32LE(*(int *)((char *)data + i * stride));
-        sampledata[i] = (4.6566128730772E-10f) * (float)x;
-    }
+    pcm::i32LEToF32((const uint8_t *)data, stride, samplesize, GetSamplePtrF32(channel));
     return true;
 }
 
 bool Sample::load_data_i32BE(int channel, void *data, unsigned int samplesize, unsigned int stride)
 {
     allocateF32(channel, samplesize);
-    float *sampledata = GetSamplePtrF32(channel);
-
-    for (int i = 0; i < samplesize; i++)
-    {
-        int x = endian_read_int32BE(*(int *)((char *)data + i * stride));
-        sampledata[i] = (4.6566128730772E-10f) * (float)x;
-    }
+    pcm::i32BEToF32((const uint8_t *)data, stride, samplesize, GetSamplePtrF32(channel));
     return true;
 }
 
 bool Sample::load_data_i24(int channel, void *data, unsigned int samplesize, unsigned int stride)
 {
-    allocateF32(channel, samplesize);
-    float *sampledata = GetSamplePtrF32(channel);
-
-    for (int i = 0; i < samplesize; i++)
+    if (!isStreamed)
     {
-        unsigned char *cval = (unsigned char *)data + i * stride;
-        int value = (cval[2] << 16) | (cval[1] << 8) | cval[0];
-        value -= (value & 0x800000) << 1;
-        sampledata[i] = 0.00000011920928955078f * float(value);
-        ;
+        allocateI24(channel, samplesize);
+        pcm::i24LEToPacked((const uint8_t *)data, stride, samplesize, GetSamplePtrI24(channel));
+        return true;
     }
+
+    allocateF32(channel, samplesize);
+    pcm::i24LEToF32((const uint8_t *)data, stride, samplesize, GetSamplePtrF32(channel));
     return true;
 }
 
 bool Sample::load_data_i24BE(int channel, void *data, unsigned int samplesize, unsigned int stride)
 {
-    allocateF32(channel, samplesize);
-    float *sampledata = GetSamplePtrF32(channel);
-
-    for (int i = 0; i < samplesize; i++)
+    if (!isStreamed)
     {
-        unsigned char *cval = (unsigned char *)data + i * stride;
-        int value = (cval[0] << 16) | (cval[1] << 8) | cval[2];
-        value -= (value & 0x800000) << 1;
-        sampledata[i] = 0.00000011920928955078f * float(value);
-        ;
+        allocateI24(channel, samplesize);
+        pcm::i24BEToPacked((const uint8_t *)data, stride, samplesize, GetSamplePtrI24(channel));
+        return true;
     }
+
+    allocateF32(channel, samplesize);
+    pcm::i24BEToF32((const uint8_t *)data, stride, samplesize, GetSamplePtrF32(channel));
     return true;
 }
 
 bool Sample::load_data_f32(int channel, void *data, unsigned int samplesize, unsigned int stride)
 {
     allocateF32(channel, samplesize);
-    float *sampledata = GetSamplePtrF32(channel);
-
-    for (int i = 0; i < samplesize; i++)
-    {
-        sampledata[i] = (*(float *)((char *)data + i * stride));
-    }
+    pcm::f32LEToF32((const uint8_t *)data, stride, samplesize, GetSamplePtrF32(channel));
     return true;
 }
 
@@ -421,6 +751,8 @@ void Sample::dumpInformationToLog()
 
     SCLOG("BitDepth=" << bitDepthByteSize(bitDepth) * 8 << " Channels=" << (int)channels);
     SCLOG("SampleRate=" << sample_rate << " sample_length=" << sample_length);
+    if (isStreamed)
+        SCLOG("Streamed from disk with " << residentLength << " frames resident");
 
     switch (bitDepth)
     {
@@ -431,7 +763,7 @@ void Sample::dumpInformationToLog()
             auto *dat = GetSamplePtrI16(c);
             auto mxv = std::numeric_limits<int16_t>::min();
             auto mnv = std::numeric_limits<int16_t>::max();
-            for (int i = 0; i < sample_length; ++i)
+            for (int i = 0; i < getResidentLength(); ++i)
             {
                 mxv = std::max(mxv, dat[i]);
                 mnv = std::min(mnv, dat[i]);
@@ -449,6 +781,11 @@ void Sample::dumpInformationToLog()
         SCLOG("TODO: Implement Sapmle Scan for F32");
     }
     break;
+    default:
+    {
+        SCLOG("TODO: Implement Sample Scan for " << bitDepthName(bitDepth));
+    }
+    break;
     }
 }
 
@@ -27,12 +27,24 @@
 #ifndef SCXT_SRC_SAMPLE_SAMPLE_H
 #define SCXT_SRC_SAMPLE_SAMPLE_H
 
+#include <memory>
+
 #include "utils.h"
+#include "dsp/sample_formats.h"
 #include "infrastructure/filesystem_import.h"
+#include "infrastructure/file_map_view.h"
+#include "sample_streamer.h"
+#include "sample_compression.h"
 #include "SF.h"
 
+namespace scxt::infrastructure
+{
+struct MD5Cache;
+}
+
 namespace scxt::sample
 {
+struct DecodedSampleCache;
 
 struct alignas(16) Sample : MoveableOnly<Sample>
 {
@@ -92,23 +104,123 @@ struct alignas(16) Sample : MoveableOnly<Sample>
                 getCompoundRegion()};
     }
 
-    size_t getDataSize() const { return sample_length * bitDepthByteSize(bitDepth) * channels; }
+    size_t getDataSize() const
+    {
+        return getResidentLength() * bitDepthByteSize(bitDepth) * channels;
+    }
     size_t getSampleLength() const { return sample_length; }
+    dsp::SampleDataFormat getSampleDataFormat() const
+    {
+        switch (bitDepth)
+        {
+        case BD_I16:
+            return dsp::SDF_I16;
+        case BD_I24:
+            return dsp::SDF_I24;
+        case BD_I8:
+            return dsp::SDF_I8;
+        default:
+            return dsp::SDF_F32;
+        }
+    }
     std::string getBitDepthText() const { return bitDepthName(bitDepth); }
+    // Over every frame, whatever is resident. See dsp::sample_analytics::cacheLevels
+    bool levelsCached{false};
+    float peakLevel{0.f}, rmsLevel{0.f};
+
 
     bool parseFlac(const fs::path &p);
     bool parseMP3(const fs::path &p);
 
+    /*
+     * Disk streaming. If enabled when load is called and the decoded sample would be
+     * larger than minimumSizeInBytes, only the first preloadFrames are decoded into
+     * sampleData (with the usual samplePadding) and the remainder is read on demand
+     * by the SampleStreamer. sample_length is always the full length of the sample;
+     * getResidentLength() is how much of it you may actually read from sampleData.
+     */
+    struct StreamingConfiguration
+    {
+        bool enabled{false};
+        size_t minimumSizeInBytes{1 << 20};
+        uint32_t preloadFrames{1 << 14};
+    } streamingConfiguration;
+
+    bool isStreamed{false};
+    uint32_t residentLength{0};
+    std::unique_ptr<StreamingSource> streamingSource;
+    size_t getResidentLength() const
+    {
+        return (isStreamed || compressedFrames) ? residentLength : sample_length;
+    }
+
+    /*
+     * In-memory compression. Losslessly compresses 8, 16 and 24 bit resident data into
+     * CompressedFrames and keeps only a decoded preload head in sampleData, as I16 (8 and
+     * 16 bit) or F32 (24 bit). Past the head each voice decodes the blocks it needs
+     * itself; see sample/compressed_playback.h. Samples smaller than the streaming
+     * minimumSizeInBytes are left alone.
+     */
+    bool compressResidentData();
+    std::unique_ptr<CompressedFrames> compressedFrames;
+    bool isCompressed() const { return compressedFrames != nullptr; }
+    size_t getCompressedDataSize() const
+    {
+        return isCompressed() ? compressedFrames->compressedBytes() : 0;
+    }
+
+    /*
+     * Zero copy loading. If mapWithoutCopy is set when load is called, mono 16 bit and
+     * float WAV files leave sampleData pointing straight into a private, lazily paged
+     * mapping of the file rather than decoding into malloced buffers. The bytes either
+     * side of the sample data are zeroed in our private view to give the generator its
+     * samplePadding.
+     */
+    bool mapWithoutCopy{false};
+    bool isMappedWithoutCopy() const { return mappedFile != nullptr; }
+
+    // If set, load consults this before hashing the file. Not owned.
+    infrastructure::MD5Cache *md5Cache{nullptr};
+
+    /*
+     * If set, FLAC and MP3 loads map previously decoded data from this cache (keyed by
+     * md5Sum) rather than running the decoder, and populate it on a miss. Not owned.
+     */
+    DecodedSampleCache *decodedCache{nullptr};
+
     void *__restrict sampleData[2]{nullptr, nullptr};
 
+    /*
+     * Decimated levels. Once built, decimatedLevels[l] holds the sample low passed and
+     * decimated by 2^(l+1), as float with the usual samplePadding. They use the same
+     * halfband filter a voice runs when it oversamples, so a voice transposing up far
+     * enough can read a level rather than render at 2x and filter for itself.
+     */
+    static constexpr int maxDecimatedLevels{2};
+    struct DecimatedLevel
+    {
+        float *data[2]{nullptr, nullptr};
+        uint32_t length{0};
+    } decimatedLevels[maxDecimatedLevels];
+    int numDecimatedLevels{0};
+    void buildDecimatedLevels();
+    float *getDecimatedSamplePtr(int level, int channel);
+    size_t getDecimatedDataSize() const;
+
     // TODO: Review evertyhing from here down before moving it above this comment
     bool parse_riff_wave(void *data, size_t filesize, bool skip_riffchunk = false);
     bool parse_aiff(void *data, size_t filesize);
     short *GetSamplePtrI16(int Channel);
     float *GetSamplePtrF32(int Channel);
+    dsp::PackedI24 *GetSamplePtrI24(int Channel);
+    int8_t *GetSamplePtrI8(int Channel);
     char *GetName();
 
   private:
+    bool setupStreaming(StreamingSource::Encoding encoding, size_t dataOffset,
+                        uint8_t bytesPerSample);
+    bool loadFromDecodedCache();
+    void storeToDecodedCache();
     bool parse_sf2_sample(void *data, size_t filesize, unsigned int sampleid);
     bool parse_dls_sample(void *data, size_t filesize, unsigned int sampleid);
 
@@ -120,12 +232,13 @@ struct alignas(16) Sample : MoveableOnly<Sample>
     // public data
     enum BitDepth
     {
-        // Right now 8 -> I16 at load and 24 -> F32 at load and noone supports 12 so just make this
-        // BD_I8,
-        // BD_I12,
+        // 8 and 24 bit data is kept packed unless the sample is streamed, in which case it
+        // widens to I16 and F32 at load. Noone supports 12. These values are persisted in
+        // the decoded sample cache so only ever add to the end.
         BD_I16,
-        // BD_I24,
-        BD_F32
+        BD_F32,
+        BD_I24,
+        BD_I8
     } bitDepth{BD_F32};
 
     static std::string bitDepthName(BitDepth bd)
@@ -136,6 +249,10 @@ struct alignas(16) Sample : MoveableOnly<Sample>
             return "I16";
         case BD_F32:
             return "F32";
+        case BD_I24:
+            return "I24";
+        case BD_I8:
+            return "I8";
         default:
             return "UNKWN";
         }
@@ -149,6 +266,10 @@ struct alignas(16) Sample : MoveableOnly<Sample>
             return 2;
         case BD_F32:
             return 4;
+        case BD_I24:
+            return 3;
+        case BD_I8:
+            return 1;
         default:
             return 1;
         }
@@ -206,6 +327,15 @@ struct alignas(16) Sample : MoveableOnly<Sample>
     } meta;
 
   private:
+    std::unique_ptr<infrastructure::FileMapView> mappedFile;
+    struct
+    {
+        bool active{false};
+        size_t offset{0}, bytes{0};
+        BitDepth bitDepth{BD_I16};
+    } pendingMapping;
+    bool adoptMapping(std::unique_ptr<infrastructure::FileMapView> &fmv);
+
     void clear_data()
     {
         // TODO: Figure Out and Implement clear_data
@@ -215,6 +345,8 @@ struct alignas(16) Sample : MoveableOnly<Sample>
   public:
     bool allocateI16(int Channel, int Samples);
     bool allocateF32(int Channel, int Samples);
+    bool allocateI24(int Channel, int Samples);
+    bool allocateI8(int Channel, int Samples);
 
     bool load_data_ui8(int channel, void *data, unsigned int samplesize, unsigned int stride);
     bool load_data_i8(int channel, void *data, unsigned int samplesize, unsigned int stride);
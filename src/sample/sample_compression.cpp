@@ -0,0 +1,198 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "sample_compression.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace scxt::sample
+{
+namespace
+{
+inline uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+inline int32_t predict(int order, const int32_t *x, uint32_t i)
+{
+    switch (order)
+    {
+    case 1:
+        return x[i - 1];
+    case 2:
+        return 2 * x[i - 1] - x[i - 2];
+    default:
+        return 0;
+    }
+}
+} // namespace
+
+void CompressedFrames::encodeBlock(int channel, const int32_t *block, uint32_t n)
+{
+    auto &out = data[channel];
+    blockOffsets[channel].push_back((uint32_t)out.size());
+
+    // Pick the predictor with the smallest total residual. This is the same cheap
+    // estimate FLAC uses to choose between its fixed predictors.
+    int order{0};
+    uint64_t best{UINT64_MAX};
+    for (int o = 0; o <= 2 && (uint32_t)o < n; ++o)
+    {
+        uint64_t sum{0};
+        for (uint32_t i = o; i < n; ++i)
+            sum += std::abs((int64_t)block[i] - predict(o, block, i));
+        if (sum < best)
+        {
+            best = sum;
+            order = o;
+        }
+    }
+
+    out.push_back((uint8_t)order);
+    for (int i = 0; i < order; ++i)
+    {
+        auto v = (uint32_t)block[i];
+        for (int b = 0; b < 4; ++b)
+            out.push_back((uint8_t)(v >> (b * 8)));
+    }
+
+    uint32_t residual[groupFrames];
+    for (uint32_t g = order; g < n; g += groupFrames)
+    {
+        auto count = std::min(groupFrames, n - g);
+        uint32_t widest{0};
+        for (uint32_t i = 0; i < groupFrames; ++i)
+        {
+            residual[i] = i < count ? zigzag(block[g + i] - predict(order, block, g + i)) : 0;
+            widest |= residual[i];
+        }
+
+        uint8_t width{0};
+        while (width < 32 && (widest >> width))
+            width++;
+        out.push_back(width);
+
+        // A full group is always written so the decoder never has to check for a
+        // short final group, and groupFrames * width is always a whole number of bytes
+        uint64_t acc{0};
+        int bits{0};
+        for (uint32_t i = 0; i < groupFrames; ++i)
+        {
+            acc |= (uint64_t)residual[i] << bits;
+            bits += width;
+            while (bits >= 8)
+            {
+                out.push_back((uint8_t)acc);
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+        assert(bits == 0);
+    }
+}
+
+void CompressedFrames::decodeBlock(int channel, uint32_t block, int32_t *dest) const
+{
+    assert(block < blockOffsets[channel].size());
+    const auto *in = data[channel].data() + blockOffsets[channel][block];
+    auto n = blockLength(block);
+
+    int order = *in++;
+    for (int i = 0; i < order; ++i)
+    {
+        dest[i] = (int32_t)(in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24));
+        in += 4;
+    }
+
+    for (uint32_t g = order; g < n; g += groupFrames)
+    {
+        auto count = std::min(groupFrames, n - g);
+        int width = *in++;
+        uint64_t mask = (uint64_t(1) << width) - 1;
+        uint64_t acc{0};
+        int bits{0};
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            while (bits < width)
+            {
+                acc |= (uint64_t)(*in++) << bits;
+                bits += 8;
+            }
+            auto r = unzigzag((uint32_t)(acc & mask));
+            acc >>= width;
+            bits -= width;
+            dest[g + i] = r + predict(order, dest, g + i);
+        }
+        // Only the final group can be short, and the next block starts at its own offset
+    }
+}
+
+void CompressedFrames::decodeFrames(int channel, int64_t from, int64_t to, bool asFloat,
+                                    void *dest, int32_t *scratch) const
+{
+    assert(asFloat || bitsPerSample <= 16);
+    auto elementSize = asFloat ? sizeof(float) : sizeof(int16_t);
+    if (to > from)
+        memset(dest, 0, (to - from) * elementSize);
+
+    auto lo = std::max(from, (int64_t)0);
+    auto hi = std::min(to, (int64_t)totalFrames);
+    auto scale = 1.f / (float)(1 << (bitsPerSample - 1));
+    auto widen = 16 - bitsPerSample;
+
+    for (auto b = (uint32_t)(lo / blockFrames); (int64_t)b * blockFrames < hi; ++b)
+    {
+        decodeBlock(channel, b, scratch);
+
+        auto blockStart = (int64_t)b * blockFrames;
+        auto s = std::max(lo, blockStart);
+        auto e = std::min(hi, blockStart + blockLength(b));
+        const auto *src = scratch + (s - blockStart);
+        if (asFloat)
+        {
+            auto *out = (float *)dest + (s - from);
+            for (int64_t i = 0; i < e - s; ++i)
+                out[i] = scale * (float)src[i];
+        }
+        else
+        {
+            auto *out = (int16_t *)dest + (s - from);
+            for (int64_t i = 0; i < e - s; ++i)
+                out[i] = (int16_t)(src[i] * (1 << widen));
+        }
+    }
+}
+
+size_t CompressedFrames::compressedBytes() const
+{
+    size_t res{0};
+    for (int c = 0; c < 2; ++c)
+        res += data[c].size() + blockOffsets[c].size() * sizeof(uint32_t);
+    return res;
+}
+} // namespace scxt::sample
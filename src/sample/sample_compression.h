@@ -0,0 +1,97 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SAMPLE_SAMPLE_COMPRESSION_H
+#define SCXT_SRC_SAMPLE_SAMPLE_COMPRESSION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace scxt::sample
+{
+/*
+ * Lossless compression for resident integer sample data. Each channel is cut into
+ * blocks of blockFrames which decode independently of each other. A block stores its
+ * first `order` samples verbatim and the rest as the residual of a fixed order 0, 1 or 2
+ * polynomial predictor (the same predictors as a FLAC fixed subframe), zigzag coded and
+ * bit packed groupFrames at a time at the width of the widest residual in the group.
+ */
+struct CompressedFrames
+{
+    static constexpr uint32_t blockFrames{4096};
+    static constexpr uint32_t groupFrames{32};
+
+    uint8_t channels{1};
+    uint8_t bitsPerSample{16}; // 8, 16 or 24
+    uint32_t totalFrames{0};
+
+    /*
+     * sampleAt(i) returns frame i of the channel as a sign extended integer at
+     * bitsPerSample. Call once per channel, in order, after setting the fields above.
+     */
+    template <typename F> void encodeChannel(int channel, F sampleAt)
+    {
+        int32_t block[blockFrames];
+        for (uint32_t s = 0; s < totalFrames; s += blockFrames)
+        {
+            auto n = std::min(blockFrames, totalFrames - s);
+            for (uint32_t i = 0; i < n; ++i)
+                block[i] = sampleAt(s + i);
+            encodeBlock(channel, block, n);
+        }
+    }
+
+    uint32_t numBlocks() const { return (totalFrames + blockFrames - 1) / blockFrames; }
+    uint32_t blockLength(uint32_t block) const
+    {
+        return std::min(blockFrames, totalFrames - block * blockFrames);
+    }
+
+    // Decodes blockLength(block) samples into dest, which must hold blockFrames
+    void decodeBlock(int channel, uint32_t block, int32_t *dest) const;
+
+    /*
+     * Decodes frames [from, to) of the channel into dest as float or, for 8 and 16 bit
+     * data, int16, in the scaling the generator expects for those formats. Frames outside
+     * the sample are zero. scratch must hold blockFrames; this never allocates so it is
+     * safe on the audio thread.
+     */
+    void decodeFrames(int channel, int64_t from, int64_t to, bool asFloat, void *dest,
+                      int32_t *scratch) const;
+
+    size_t compressedBytes() const;
+
+  private:
+    void encodeBlock(int channel, const int32_t *block, uint32_t n);
+
+    std::vector<uint8_t> data[2];
+    std::vector<uint32_t> blockOffsets[2]; // byte offset of each block in data
+};
+} // namespace scxt::sample
+
+#endif // SHORTCIRCUITXT_SAMPLE_COMPRESSION_H
@@ -26,46 +26,170 @@
  */
 
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include "sample_manager.h"
 #include "infrastructure/md5support.h"
+#include "pcm_conversion.h"
 
 namespace scxt::sample
 {
 
 void SampleManager::restoreFromSampleAddressesAndIDs(const sampleAddressesAndIds_t &r)
 {
+    assert(threadingChecker.isSerialThread());
+
+    // First sort out the files we can load independently from the ones which share handles
+    std::vector<std::pair<SampleID, Sample::SampleFileAddress>> parallelLoads, serialLoads;
     for (const auto &[id, addr] : r)
     {
         if (!fs::exists(addr.path))
         {
             missingList.push_back(addr.path);
+            continue;
         }
-        else
+
+        switch (addr.type)
         {
-            switch (addr.type)
-            {
-            case Sample::WAV_FILE:
-            case Sample::FLAC_FILE:
-            case Sample::MP3_FILE:
-            case Sample::AIFF_FILE:
+        case Sample::WAV_FILE:
+        case Sample::FLAC_FILE:
+        case Sample::MP3_FILE:
+        case Sample::AIFF_FILE:
+            parallelLoads.emplace_back(id, addr);
+            break;
+        case Sample::SF2_FILE:
+        case Sample::MULTISAMPLE_FILE:
+            serialLoads.emplace_back(id, addr);
+            break;
+        }
+    }
+
+    if (!parallelLoads.empty())
+    {
+        // IDs are handed out on this thread so make sure they are reserved before we fan out
+        for (const auto &[id, addr] : parallelLoads)
+            SampleID::guaranteeNextAbove(id);
+
+        std::vector<std::shared_ptr<Sample>> loaded(parallelLoads.size());
+        std::atomic<size_t> nextJob{0}, jobsDone{0};
+
+        auto worker = [&]() {
+            // We are already one of nThreads so don't fan each conversion out again
+            pcm::SingleThreadedScope singleThreaded;
+            auto job = nextJob++;
+            while (job < parallelLoads.size())
             {
-                loadSampleByPathToID(addr.path, id);
+                const auto &[id, addr] = parallelLoads[job];
+                auto sp = makeSampleForPathLoad(id);
+                if (sp->load(addr.path))
+                {
+                    prepareLoadedSample(*sp);
+                    loaded[job] = sp;
+                }
+                else
+                    SCLOG("Failed to load sample from '" << addr.path.u8string() << "'");
+                jobsDone++;
+                job = nextJob++;
             }
-            break;
-            case Sample::SF2_FILE:
+        };
+
+        auto nThreads = std::clamp((size_t)std::thread::hardware_concurrency(), (size_t)1,
+                                   std::min(maxLoaderThreads, parallelLoads.size()));
+        SCLOG("Restoring " << parallelLoads.size() << " samples on " << nThreads << " threads");
+
+        std::vector<std::thread> pool;
+        for (size_t i = 0; i < nThreads; ++i)
+            pool.emplace_back(worker);
+
+        size_t lastReported{0};
+        while (jobsDone < parallelLoads.size())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            auto done = jobsDone.load();
+            if (onLoadProgress && done != lastReported)
             {
-                loadSampleFromSF2ToID(addr.path, nullptr, addr.preset, addr.instrument, addr.region,
-                                      id);
+                onLoadProgress("Loading samples (" + std::to_string(done) + " of " +
+                               std::to_string(parallelLoads.size()) + ")");
+                lastReported = done;
             }
-            break;
-            case Sample::MULTISAMPLE_FILE:
+        }
+        for (auto &t : pool)
+            t.join();
+
+        // and publish in the original order on this thread
+        for (const auto &sp : loaded)
+        {
+            if (!sp)
+                continue;
+
+            bool dupe{false};
+            for (const auto &[alreadyId, sm] : samples)
             {
-                loadSampleFromMultiSample(addr.path, addr.region, id);
+                if (sm->getPath() == sp->getPath())
+                {
+                    SCLOG("Potential concern: Restored '"
+                          << sp->getPath().u8string() << "' into " << sp->id.to_string()
+                          << " but it already exists at " << alreadyId.to_string());
+                    dupe = true;
+                    break;
+                }
             }
+            if (!dupe)
+                publishSample(sp);
+        }
+    }
+
+    for (const auto &[id, addr] : serialLoads)
+    {
+        switch (addr.type)
+        {
+        case Sample::SF2_FILE:
+        {
+            loadSampleFromSF2ToID(addr.path, nullptr, addr.preset, addr.instrument, addr.region,
+                                  id);
+        }
+        break;
+        case Sample::MULTISAMPLE_FILE:
+        {
+            loadSampleFromMultiSample(addr.path, addr.region, id);
+        }
+        break;
+        default:
             break;
-            }
         }
     }
+    updateSampleMemory();
+}
+
+std::shared_ptr<Sample> SampleManager::makeSampleForPathLoad(const SampleID &id) const
+{
+    auto sp = std::make_shared<Sample>(id);
+    sp->streamingConfiguration = streamingConfiguration;
+    sp->mapWithoutCopy = mapSamplesWithoutCopy;
+    sp->md5Cache = md5Cache;
+    sp->decodedCache = decodedSampleCache.get();
+    return sp;
+}
+
+void SampleManager::prepareLoadedSample(Sample &s) const
+{
+    if (precomputeDecimatedLevels)
+        s.buildDecimatedLevels();
+    // After the decimated levels, which are built from the full resident data
+    if (compressResidentSamples)
+        s.compressResidentData();
+}
+
+void SampleManager::publishSample(const std::shared_ptr<Sample> &sp)
+{
+    assert(threadingChecker.isSerialThread());
+    if (sp->isStreamed)
+    {
+        streamer->ensureRunning();
+    }
+    samples[sp->id] = sp;
 }
 
 SampleManager::~SampleManager() { SCLOG("Destroying Sample Manager"); }
@@ -101,7 +225,7 @@ std::optional<SampleID> SampleManager::loadSampleByPathToID(const fs::path &p, c
 
     SCLOG("Loading [" << p.u8string() << "]  @ [" << id.to_string() << "]");
 
-    auto sp = std::make_shared<Sample>(id);
+    auto sp = makeSampleForPathLoad(id);
 
     if (!sp->load(p))
     {
@@ -109,7 +233,8 @@ std::optional<SampleID> SampleManager::loadSampleByPathToID(const fs::path &p, c
         return std::nullopt;
     }
 
-    samples[sp->id] = sp;
+    prepareLoadedSample(*sp);
+    publishSample(sp);
     updateSampleMemory();
     return sp->id;
 }
@@ -135,7 +260,7 @@ std::optional<SampleID> SampleManager::loadSampleFromSF2ToID(const fs::path &p,
                 auto riff = std::make_unique<RIFF::File>(p.u8string());
                 auto sf = std::make_unique<sf2::File>(riff.get());
                 sf2FilesByPath[p.u8string()] = {std::move(riff), std::move(sf),
-                                                infrastructure::createMD5SumFromFile(p)};
+                                                infrastructure::createMD5SumFromFile(p, md5Cache)};
             }
             catch (RIFF::Exception e)
             {
@@ -163,7 +288,8 @@ std::optional<SampleID> SampleManager::loadSampleFromSF2ToID(const fs::path &p,
 
     sp->md5Sum = std::get<2>(sf2FilesByPath[p.u8string()]);
 
-    samples[sp->id] = sp;
+    prepareLoadedSample(*sp);
+    publishSample(sp);
     updateSampleMemory();
     return sp->id;
 }
@@ -178,7 +304,8 @@ std::optional<SampleID> SampleManager::setupSampleFromMultifile(const fs::path &
     sp->type = Sample::MULTISAMPLE_FILE;
     sp->region = idx;
     sp->mFileName = p;
-    samples[sp->id] = sp;
+    prepareLoadedSample(*sp);
+    publishSample(sp);
     updateSampleMemory();
     return sp->id;
 }
@@ -203,7 +330,8 @@ std::optional<SampleID> SampleManager::loadSampleFromMultiSample(const fs::path
     sp->type = Sample::MULTISAMPLE_FILE;
     sp->region = idx;
     sp->mFileName = p;
-    samples[sp->id] = sp;
+    prepareLoadedSample(*sp);
+    publishSample(sp);
     updateSampleMemory();
 
     free(data);
@@ -242,7 +370,13 @@ void SampleManager::updateSampleMemory()
     uint64_t res = 0;
     for (const auto &[id, smp] : samples)
     {
-        res += smp->sample_length * smp->channels * (smp->bitDepth == Sample::BD_I16 ? 4 : 8);
+        res += smp->getDecimatedDataSize();
+        res += smp->getCompressedDataSize();
+        // mapped samples live in file backed pages which the OS can drop and re-read
+        if (smp->isMappedWithoutCopy())
+            continue;
+        res += smp->getResidentLength() * smp->channels *
+               Sample::bitDepthByteSize(smp->bitDepth) * 2;
     }
     sampleMemoryInBytes = res;
 }
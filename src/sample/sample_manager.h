@@ -30,6 +30,7 @@
 
 #include "utils.h"
 #include "sample.h"
+#include "decoded_sample_cache.h"
 
 #include "infrastructure/filesystem_import.h"
 
@@ -38,6 +39,7 @@
 #include <optional>
 #include <vector>
 #include <utility>
+#include <functional>
 #include "SF.h"
 #include <miniz.h>
 
@@ -114,7 +116,20 @@ struct SampleManager : MoveableOnly<SampleManager>
         }
         return res;
     }
+    /*
+     * Restoring loads every file backed sample on a pool of worker threads, which
+     * decode and hash in parallel, and then publishes the results into the sample
+     * map on the calling (serial) thread. SF2 and multisample sources share open
+     * file handles so they still load one after another.
+     */
     void restoreFromSampleAddressesAndIDs(const sampleAddressesAndIds_t &);
+    static constexpr size_t maxLoaderThreads{8};
+
+    /*
+     * Long running loads report their progress through this. The engine wires it
+     * to the client activity notification.
+     */
+    std::function<void(const std::string &)> onLoadProgress{nullptr};
 
     void purgeUnreferencedSamples();
 
@@ -133,8 +148,34 @@ struct SampleManager : MoveableOnly<SampleManager>
 
     std::atomic<uint64_t> sampleMemoryInBytes{0};
 
+    /*
+     * Samples loaded by path pick up this configuration, so large WAV files can be
+     * streamed from disk through the streamer rather than fully decoded into memory.
+     */
+    Sample::StreamingConfiguration streamingConfiguration;
+    // Samples loaded by path map mono 16 bit and float WAV data without copying
+    bool mapSamplesWithoutCopy{false};
+    /*
+     * Build each loaded sample's decimated levels so voices transposing up an octave or
+     * more read pre-filtered data rather than oversample and filter per voice.
+     */
+    bool precomputeDecimatedLevels{false};
+    /*
+     * Losslessly compress loaded integer samples larger than the streaming minimum. Voices
+     * decode them as they play (see sample/compressed_playback.h).
+     */
+    bool compressResidentSamples{false};
+    // A persistent hash cache (the browser database) so unchanged files are not rehashed
+    infrastructure::MD5Cache *md5Cache{nullptr};
+    // If present, FLAC and MP3 decodes are cached on disk and mapped on later loads
+    std::unique_ptr<DecodedSampleCache> decodedSampleCache;
+    std::unique_ptr<SampleStreamer> streamer{std::make_unique<SampleStreamer>()};
+
   private:
     void updateSampleMemory();
+    std::shared_ptr<Sample> makeSampleForPathLoad(const SampleID &id) const;
+    void prepareLoadedSample(Sample &s) const;
+    void publishSample(const std::shared_ptr<Sample> &sp);
 
     std::unordered_map<SampleID, std::shared_ptr<Sample>> samples;
     std::unordered_map<std::string, std::tuple<std::unique_ptr<RIFF::File>,
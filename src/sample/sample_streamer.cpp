@@ -0,0 +1,384 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "sample_streamer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <optional>
+
+#include "sst/basic-blocks/mechanics/endian-ops.h"
+
+#include "sample.h"
+#include "pcm_conversion.h"
+#include "dsp/generator.h"
+#include "dsp/resampling.h"
+
+namespace scxt::sample
+{
+// Fine in a cpp
+using namespace sst::basic_blocks::mechanics;
+
+bool StreamingSource::read(int64_t start, int64_t count, bool asFloat, void *destL, void *destR)
+{
+    void *dest[2]{destL, destR};
+    auto elementSize = asFloat ? sizeof(float) : sizeof(int16_t);
+    for (auto *d : dest)
+        if (d)
+            memset(d, 0, count * elementSize);
+
+    auto from = std::clamp(start, (int64_t)0, (int64_t)totalFrames);
+    auto to = std::clamp(start + count, (int64_t)0, (int64_t)totalFrames);
+    if (to <= from)
+        return true;
+
+    if (!stream.is_open())
+    {
+        stream.open(path, std::ios::binary);
+        if (!stream.is_open())
+            return false;
+    }
+
+    auto frameBytes = (size_t)channels * bytesPerSample;
+    scratch.resize((to - from) * frameBytes);
+    stream.clear();
+    stream.seekg(dataOffset + from * frameBytes);
+    stream.read((char *)scratch.data(), scratch.size());
+    if ((size_t)stream.gcount() != scratch.size())
+        return false;
+
+    auto offset = from - start;
+    auto n = to - from;
+    for (int c = 0; c < std::min((int)channels, 2); ++c)
+    {
+        if (!dest[c])
+            continue;
+
+        auto *src = scratch.data() + c * bytesPerSample;
+        if (asFloat)
+        {
+            auto *out = (float *)dest[c] + offset;
+            switch (encoding)
+            {
+            case PCM_I24:
+                pcm::i24LEToF32(src, frameBytes, n, out);
+                continue;
+            case PCM_I32:
+                pcm::i32LEToF32(src, frameBytes, n, out);
+                continue;
+            case FLOAT_F32:
+                pcm::f32LEToF32(src, frameBytes, n, out);
+                continue;
+            default:
+                break;
+            }
+            for (int64_t i = 0; i < n; ++i)
+            {
+                auto *cval = src + i * frameBytes;
+                switch (encoding)
+                {
+                case FLOAT_F64:
+                    out[i] = (float)(*(double *)cval);
+                    break;
+                default:
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            auto *out = (int16_t *)dest[c] + offset;
+            if (encoding == PCM_I16)
+            {
+                pcm::i16LEToI16(src, frameBytes, n, out);
+                continue;
+            }
+            for (int64_t i = 0; i < n; ++i)
+            {
+                auto *cval = src + i * frameBytes;
+                switch (encoding)
+                {
+                case PCM_U8:
+                    out[i] = (((short)*cval) - 128) << 8;
+                    break;
+                default:
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+SampleStreamer::SampleStreamer() {}
+
+SampleStreamer::~SampleStreamer()
+{
+    keepRunning = false;
+    if (ioThread)
+    {
+        ioThread->join();
+    }
+}
+
+void SampleStreamer::ensureRunning()
+{
+    if (isRunning())
+        return;
+
+    SCLOG("Starting sample streamer with " << maxStreamingVoices << " voice slots");
+    for (auto &sl : slots)
+    {
+        for (auto &w : sl.windows)
+        {
+            for (auto &d : w.data)
+                d = std::make_unique<float[]>(windowFrames + 2 * dsp::samplePadding);
+        }
+    }
+
+    keepRunning = true;
+    ioThread = std::make_unique<std::thread>([this]() { runIO(); });
+    running.store(true, std::memory_order_release);
+}
+
+SampleStreamer::Slot *SampleStreamer::acquireSlot(const std::shared_ptr<Sample> &s)
+{
+    if (!isRunning())
+        return nullptr;
+
+    for (auto &sl : slots)
+    {
+        bool expected{false};
+        if (sl.inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+        {
+            sl.sample = s;
+            sl.current = -1;
+            for (auto &w : sl.windows)
+                w.state.store(Window::EMPTY, std::memory_order_release);
+            return &sl;
+        }
+    }
+    return nullptr;
+}
+
+void SampleStreamer::releaseSlot(Slot *slot)
+{
+    // The queue is sized so it holds every outstanding request for every slot
+    // so this push cannot fail, and the I/O thread is the one which drops our
+    // sample reference, so we never free a sample on the audio thread.
+    [[maybe_unused]] auto res = requests.push({Request::RELEASE, slot, 0});
+    assert(res);
+}
+
+void SampleStreamer::requestWindow(Slot &slot, int32_t which, int64_t start)
+{
+    auto &w = slot.windows[which];
+    w.start = start;
+    w.state.store(Window::REQUESTED, std::memory_order_release);
+    if (!requests.push({Request::FILL, &slot, which}))
+        w.state.store(Window::EMPTY, std::memory_order_release);
+}
+
+void SampleStreamer::blockFrameRange(const dsp::GeneratorState &GD, bool loopActive,
+                                     int64_t length, int64_t &lo, int64_t &hi)
+{
+    int64_t pos = GD.samplePos;
+    int64_t span =
+        (((int64_t)std::abs(GD.ratio) * GD.blockSize) >> 24) + 2 * dsp::samplePadding + 2;
+    bool forward = GD.direction * (GD.ratio < 0 ? -1 : 1) >= 0;
+
+    /*
+     * Inside a loop we could wrap or crossfade, both of which read the far end of the
+     * loop, so once that is possible the range has to hold the entire loop.
+     */
+    lo = pos - span;
+    hi = pos + span;
+    if (loopActive)
+    {
+        auto loopLo = (int64_t)GD.loopLowerBound - GD.loopFade - 2 * dsp::samplePadding;
+        auto loopHi = (int64_t)GD.loopUpperBound + 2 * dsp::samplePadding;
+        if ((forward && hi >= GD.loopUpperBound - GD.loopFade) ||
+            (!forward && lo <= GD.loopLowerBound + GD.loopFade))
+        {
+            lo = std::min(lo, loopLo);
+            hi = std::max(hi, loopHi);
+        }
+    }
+    lo = std::clamp(lo, (int64_t)0, length);
+    hi = std::clamp(hi, (int64_t)0, length);
+}
+
+bool SampleStreamer::prepareBlock(Slot &slot, const dsp::GeneratorState &GD, bool loopActive,
+                                  int64_t &base, void *&dataL, void *&dataR)
+{
+    auto &s = *slot.sample;
+    int64_t length = s.sample_length;
+    int64_t resident = s.residentLength;
+    int64_t pos = GD.samplePos;
+    bool forward = GD.direction * (GD.ratio < 0 ? -1 : 1) >= 0;
+
+    int64_t lo, hi;
+    blockFrameRange(GD, loopActive, length, lo, hi);
+    int64_t loopLo = (int64_t)GD.loopLowerBound - GD.loopFade - 2 * dsp::samplePadding;
+    int64_t loopHi = (int64_t)GD.loopUpperBound + 2 * dsp::samplePadding;
+
+    auto sourceCovers = [&](int32_t w) {
+        if (w < 0)
+            return hi <= resident;
+        return slot.windows[w].covers(lo, hi);
+    };
+
+    bool covered = sourceCovers(slot.current);
+    if (!covered)
+    {
+        for (auto w : {-1, 0, 1})
+        {
+            if (sourceCovers(w))
+            {
+                slot.current = w;
+                covered = true;
+                break;
+            }
+        }
+    }
+
+    // Now schedule the window which follows whatever we are reading from
+    std::optional<int64_t> next;
+    if (covered)
+    {
+        int64_t curStart = slot.current < 0 ? 0 : slot.windows[slot.current].start;
+        int64_t curEnd = slot.current < 0 ? resident : curStart + windowFrames;
+
+        bool holdsLoop = loopActive && loopLo >= curStart && loopHi <= curEnd;
+        if (!holdsLoop)
+        {
+            if (forward && curEnd < length)
+                next = curEnd - windowGuard;
+            else if (!forward && curStart > 0)
+                next = curStart + windowGuard - windowFrames;
+        }
+    }
+    else
+    {
+        next = forward ? pos - windowGuard : pos + windowGuard - windowFrames;
+    }
+
+    if (next.has_value())
+    {
+        auto nextStart = *next;
+        // Don't slide past the window which holds the entire loop. Once we get there
+        // we park on it for as long as we loop.
+        if (loopActive && loopHi - loopLo <= windowFrames)
+        {
+            if (forward)
+                nextStart = std::min(nextStart, loopLo);
+            else
+                nextStart = std::max(nextStart, loopHi - windowFrames);
+        }
+        nextStart = std::max(nextStart, (int64_t)0);
+
+        auto other = slot.current < 0 ? 0 : 1 - slot.current;
+        auto &w = slot.windows[other];
+        auto state = w.state.load(std::memory_order_acquire);
+        if (state != Window::REQUESTED && !(state == Window::READY && w.start == nextStart))
+            requestWindow(slot, other, nextStart);
+    }
+
+    if (!covered)
+        return false;
+
+    auto isFloat = s.bitDepth == Sample::BD_F32;
+    if (slot.current < 0)
+    {
+        base = 0;
+        dataL = isFloat ? (void *)s.GetSamplePtrF32(0) : (void *)s.GetSamplePtrI16(0);
+        dataR = isFloat ? (void *)s.GetSamplePtrF32(1) : (void *)s.GetSamplePtrI16(1);
+    }
+    else
+    {
+        auto &w = slot.windows[slot.current];
+        base = w.start;
+        if (isFloat)
+        {
+            dataL = w.data[0].get() + dsp::samplePadding;
+            dataR = w.data[1].get() + dsp::samplePadding;
+        }
+        else
+        {
+            dataL = (int16_t *)w.data[0].get() + dsp::samplePadding;
+            dataR = (int16_t *)w.data[1].get() + dsp::samplePadding;
+        }
+    }
+    return true;
+}
+
+void SampleStreamer::runIO()
+{
+    while (keepRunning.load(std::memory_order_acquire))
+    {
+        auto r = requests.pop();
+        if (!r.has_value())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        auto &slot = *(r->slot);
+        switch (r->type)
+        {
+        case Request::FILL:
+        {
+            auto &w = slot.windows[r->window];
+            auto &s = slot.sample;
+            bool ok{false};
+            if (s && s->streamingSource)
+            {
+                auto isFloat = s->bitDepth == Sample::BD_F32;
+                // Read samplePadding either side so the window is laid out like a loaded
+                // sample
+                ok = s->streamingSource->read(w.start - dsp::samplePadding,
+                                              windowFrames + 2 * dsp::samplePadding, isFloat,
+                                              w.data[0].get(),
+                                              s->channels > 1 ? w.data[1].get() : nullptr);
+            }
+            w.state.store(ok ? Window::READY : Window::EMPTY, std::memory_order_release);
+        }
+        break;
+        case Request::RELEASE:
+        {
+            slot.sample.reset();
+            for (auto &w : slot.windows)
+                w.state.store(Window::EMPTY, std::memory_order_release);
+            slot.inUse.store(false, std::memory_order_release);
+        }
+        break;
+        }
+    }
+}
+} // namespace scxt::sample
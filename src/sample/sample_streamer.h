@@ -0,0 +1,191 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SAMPLE_SAMPLE_STREAMER_H
+#define SCXT_SRC_SAMPLE_SAMPLE_STREAMER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "sst/cpputils/ring_buffer.h"
+
+#include "utils.h"
+#include "infrastructure/filesystem_import.h"
+
+namespace scxt::dsp
+{
+struct GeneratorState;
+}
+
+namespace scxt::sample
+{
+struct Sample;
+
+/*
+ * A StreamingSource knows where the sample frames of a disk streamed sample live in
+ * its file and how to convert a range of them into the in-memory format the
+ * generator expects. It is only ever read from the streamer I/O thread, after being
+ * set up on the serial thread at load time.
+ */
+struct StreamingSource
+{
+    enum Encoding
+    {
+        PCM_U8,
+        PCM_I16,
+        PCM_I24,
+        PCM_I32,
+        FLOAT_F32,
+        FLOAT_F64
+    } encoding{PCM_I16};
+
+    fs::path path{};
+    size_t dataOffset{0}; // byte offset of frame 0 in the file
+    uint8_t channels{1};
+    uint8_t bytesPerSample{2};
+    uint32_t totalFrames{0};
+
+    /*
+     * Read frames [start, start + count) into destL / destR as either float or int16
+     * (matching the Sample bitDepth). Frames outside the sample are zero filled so
+     * callers can ask for FIR padding around the edges.
+     */
+    bool read(int64_t start, int64_t count, bool asFloat, void *destL, void *destR);
+
+  private:
+    std::ifstream stream;
+    std::vector<uint8_t> scratch;
+};
+
+/*
+ * The SampleStreamer keeps a fixed set of voice slots, each with two windows of
+ * decoded audio, and a background I/O thread which refills them. A streamed sample
+ * keeps only a preload head resident, laid out exactly like a fully loaded sample
+ * (samplePadding zero pad either side), so voices start from memory and switch over
+ * to the windows as they move past the head.
+ *
+ * Threading: slots are acquired on the audio thread and handed back through the
+ * request queue, so the I/O thread is the only one which ever drops the sample
+ * reference or marks a slot free. Window buffers are allocated once on the serial
+ * thread the first time a streamed sample is loaded.
+ */
+struct SampleStreamer : MoveableOnly<SampleStreamer>
+{
+    static constexpr int32_t windowFrames{1 << 15};
+    // How far before the end of the current source we start the next window. Has
+    // to be comfortably larger than the samples a single block can read
+    static constexpr int32_t windowGuard{2048};
+    static constexpr int maxStreamingVoices{128};
+
+    SampleStreamer();
+    ~SampleStreamer();
+
+    struct Window
+    {
+        enum State : int32_t
+        {
+            EMPTY,
+            REQUESTED,
+            READY
+        };
+        std::atomic<int32_t> state{EMPTY};
+        int64_t start{0};
+
+        // Each channel holds windowFrames + 2 * samplePadding samples, sized for float so
+        // the int16 case simply uses the front half
+        std::unique_ptr<float[]> data[2];
+
+        bool covers(int64_t from, int64_t to) const
+        {
+            return state.load(std::memory_order_acquire) == READY && from >= start &&
+                   to <= start + windowFrames;
+        }
+    };
+
+    struct Slot
+    {
+        std::atomic<bool> inUse{false};
+        std::shared_ptr<Sample> sample;
+        std::array<Window, 2> windows;
+
+        // Audio thread only. -1 means we are reading from the resident head
+        int32_t current{-1};
+    };
+
+    /*
+     * Serial thread. Allocates the window buffers and starts the I/O thread
+     * the first time it is called
+     */
+    void ensureRunning();
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+    // Audio thread.
+    Slot *acquireSlot(const std::shared_ptr<Sample> &s);
+    void releaseSlot(Slot *slot);
+
+    /*
+     * Audio thread. Before each generator block, pick the source (resident head or
+     * window) which covers every frame the block could read, schedule the window
+     * after it, and return the data pointers and the rebase offset for the generator
+     * state. Returns false if nothing resident covers the block, which is an underrun.
+     */
+    bool prepareBlock(Slot &slot, const dsp::GeneratorState &GD, bool loopActive, int64_t &base,
+                      void *&dataL, void *&dataR);
+
+    // The range of frames [lo, hi) within [0, length) which the next block could read
+    static void blockFrameRange(const dsp::GeneratorState &GD, bool loopActive, int64_t length,
+                                int64_t &lo, int64_t &hi);
+
+  private:
+    struct Request
+    {
+        enum Type
+        {
+            FILL,
+            RELEASE
+        } type{FILL};
+        Slot *slot{nullptr};
+        int32_t window{0};
+    };
+
+    void requestWindow(Slot &slot, int32_t which, int64_t start);
+    void runIO();
+
+    std::array<Slot, maxStreamingVoices> slots;
+    sst::cpputils::SimpleRingBuffer<Request, maxStreamingVoices * 4> requests;
+
+    std::atomic<bool> running{false}, keepRunning{false};
+    std::unique_ptr<std::thread> ioThread;
+};
+} // namespace scxt::sample
+
+#endif // SHORTCIRCUITXT_SAMPLE_STREAMER_H
@@ -55,27 +55,34 @@ Voice::~Voice()
         SCLOG("WARNING: Destroying assigned voice. (OK in shutdown)");
     }
 #endif
-    for (auto i = 0; i < engine::processorCount; ++i)
-    {
-        dsp::processor::unspawnProcessor(processors[i]);
-        processors[i] = nullptr;
-    }
+    releaseCompressedWindow();
+    releaseProcessors();
 }
 
 void Voice::cleanupVoice()
 {
+    releaseStreamSlot();
+    releaseCompressedWindow();
+
+    // We cleanup processors here since they may have, say,
+    // memory pool resources checked out that others could
+    // use which they don't need to hold onto. Pooled ones go back
+    // to the zone still warm.
+    releaseProcessors();
+
     zone->removeVoice(this);
     zone = nullptr;
     isVoiceAssigned = false;
     engine->voiceManagerResponder.doVoiceEndCallback(this);
     engine->activeVoices--;
+}
 
-    // We cleanup processors here since they may have, say,
-    // memory pool resources checked out that others could
-    // use which they don't need to hold onto
+void Voice::releaseProcessors()
+{
     for (auto i = 0; i < engine::processorCount; ++i)
     {
-        dsp::processor::unspawnProcessor(processors[i]);
+        if (!zone || !zone->warmProcessors.release(processors[i]))
+            dsp::processor::unspawnProcessor(processors[i]);
         processors[i] = nullptr;
     }
 }
@@ -83,10 +90,20 @@ void Voice::cleanupVoice()
 void Voice::voiceStarted()
 {
     forceOversample = zone->parentGroup->outputInfo.oversample;
+    silentSamples = 0;
+    audioRatePitch = engine->audioRatePitchModulation;
+    previousRatio = 0;
 
     lfosActive = zone->lfosActive;
     egsActive = zone->egsActive;
 
+    // Shared LFOs run in the zone; see Zone::processSharedLFOs
+    for (auto i = 0U; i < engine::lfosPerZone; ++i)
+    {
+        if (zone->isLFOShared(i))
+            lfosActive[i] = false;
+    }
+
     for (auto i = 0U; i < engine::lfosPerZone; ++i)
     {
         const auto &ms = zone->modulatorStorage[i];
@@ -96,6 +113,11 @@ void Voice::voiceStarted()
     startBeat = engine->transport.timeInBeats;
     updateTransportPhasors();
 
+    startDelay = std::clamp(engine->eventSampleOffset, (int16_t)0, (int16_t)(blockSize - 1));
+    startDelayTail = false;
+    if (startDelay)
+        memset(startDelayLine, 0, sizeof(startDelayLine));
+
     // This order matters
     endpoints->sources.bind(modMatrix, *zone, *this);
     modMatrix.prepare(zone->routingTable);
@@ -167,6 +189,17 @@ template <bool OS> bool Voice::processWithOS()
         return true;
     }
 
+    if (startDelayTail)
+    {
+        memset(output, 0, sizeof(output));
+        const int d{startDelay << (OS ? 1 : 0)};
+        for (int c = 0; c < 2; ++c)
+            memcpy(output[c], startDelayLine[c], d * sizeof(float));
+        startDelayTail = false;
+        isVoicePlaying = false;
+        return true;
+    }
+
     // Run Modulators - these run at base rate never oversampled
     for (auto i = 0; i < engine::lfosPerZone; ++i)
     {
@@ -245,6 +278,14 @@ template <bool OS> bool Voice::processWithOS()
 
     auto fpitch = calculateVoicePitch();
     calculateGeneratorRatio(fpitch);
+    if (sampleIndex >= 0 && !GD.isFinished && Generator)
+    {
+        // Pitch can move a long way from where the note started, so follow it
+        auto level = pickDecimatedLevel(GD.ratio);
+        if (level != decimatedLevel)
+            setDecimatedLevel(level);
+    }
+    GD.ratio = GD.ratio >> decimatedLevel;
     if (useOversampling)
         GD.ratio = GD.ratio >> 1;
     fpitch -= 69;
@@ -265,7 +306,12 @@ template <bool OS> bool Voice::processWithOS()
     }
     if (!GD.isFinished && Generator)
     {
-        Generator(&GD, &GDIO);
+        if (streamSlot)
+            runStreamingGenerator();
+        else if (compressedWindow.isAttached())
+            runCompressedGenerator();
+        else
+            runGenerator();
 
         if (useOversampling && !OS)
         {
@@ -491,17 +537,80 @@ template <bool OS> bool Voice::processWithOS()
         }
     }
 
+    if (startDelay)
+        applyStartDelay<OS>();
+
     /*
      * Finally do voice state update
      */
-    if (isAEGRunning)
+    if (isAEGRunning && !hasGoneSilent<OS>())
         isVoicePlaying = true;
     else
         isVoicePlaying = false;
+    holdForStartDelayTail();
 
     return true;
 }
 
+template <bool OS> void Voice::applyStartDelay()
+{
+    static constexpr int bs{blockSize << (OS ? 1 : 0)};
+    const int d{startDelay << (OS ? 1 : 0)};
+    float overhang alignas(16)[blockSize << 1];
+    for (int c = 0; c < 2; ++c)
+    {
+        memcpy(overhang, output[c] + bs - d, d * sizeof(float));
+        memmove(output[c] + d, output[c], (bs - d) * sizeof(float));
+        memcpy(output[c], startDelayLine[c], d * sizeof(float));
+        memcpy(startDelayLine[c], overhang, d * sizeof(float));
+    }
+}
+
+template <bool OS> bool Voice::hasGoneSilent()
+{
+    if (isGeneratorRunning)
+    {
+        /*
+         * A quiet block from a running generator may just be a gap in the sample, so
+         * only the AEG can retire us here. It scales everything after the processors,
+         * and once releasing below the threshold it only gets quieter.
+         */
+        silentSamples = 0;
+        if (aeg.stage != ahdsrenv_t::s_release)
+            return false;
+        auto level =
+            OS ? aegOS.outputCache[(blockSize << 1) - 1] : aeg.outputCache[blockSize - 1];
+        return std::fabs(level) < silenceThreshold;
+    }
+
+    static constexpr int bs{blockSize << (OS ? 1 : 0)};
+    const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    auto peak = _mm_setzero_ps();
+    for (int c = 0; c < 2; ++c)
+        for (int i = 0; i < bs; i += 4)
+            peak = _mm_max_ps(peak, _mm_and_ps(absMask, _mm_load_ps(output[c] + i)));
+    peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+    peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, _MM_SHUFFLE(1, 1, 1, 1)));
+    if (_mm_cvtss_f32(peak) >= silenceThreshold)
+    {
+        silentSamples = 0;
+        return false;
+    }
+    silentSamples += blockSize;
+
+    auto hold = (int32_t)(silenceHoldSeconds * sampleRate);
+    for (auto *p : processors)
+    {
+        if (!p)
+            continue;
+        auto tl = p->tail_length();
+        if (tl == -1)
+            return false;
+        hold = std::max(hold, tl);
+    }
+    return silentSamples > hold;
+}
+
 void Voice::panOutputsBy(bool chainIsMono, const lipol &plip)
 {
     namespace pl = sst::basic_blocks::dsp::pan_laws;
@@ -534,6 +643,7 @@ void Voice::panOutputsBy(bool chainIsMono, const lipol &plip)
 
 void Voice::initializeGenerator()
 {
+    decimatedLevel = 0;
     if (sampleIndex < 0)
     {
         // For now we just null out the generator and deal but an alternate
@@ -552,21 +662,6 @@ void Voice::initializeGenerator()
 
     GDIO.outputL = output[0];
     GDIO.outputR = output[1];
-    if (s->bitDepth == sample::Sample::BD_I16)
-    {
-        GDIO.sampleDataL = s->GetSamplePtrI16(0);
-        GDIO.sampleDataR = s->GetSamplePtrI16(1);
-    }
-    else if (s->bitDepth == sample::Sample::BD_F32)
-    {
-        GDIO.sampleDataL = s->GetSamplePtrF32(0);
-        GDIO.sampleDataR = s->GetSamplePtrF32(1);
-    }
-    else
-    {
-        assert(false);
-    }
-    GDIO.waveSize = s->sample_length;
 
     GD.samplePos = variantData.startSample;
     GD.sampleSubPos = 0;
@@ -578,7 +673,64 @@ void Voice::initializeGenerator()
     GD.direction = 1;
     GD.isFinished = false;
 
-    if (variantData.loopActive)
+    releaseStreamSlot();
+    releaseCompressedWindow();
+    auto loopActive = variantData.loopActive;
+    if (s->isStreamed)
+    {
+        /*
+         * A streamed voice has to find an entire loop (and its fade) in one window.
+         * If it won't fit, and the loop isn't in the resident head anyway, we play
+         * through the loop rather than stall at every wrap.
+         */
+        auto loopSpan = variantData.endLoop - variantData.startLoop + variantData.loopFade +
+                        4 * dsp::samplePadding;
+        if (loopActive && variantData.endLoop + 2 * dsp::samplePadding > s->getResidentLength() &&
+            loopSpan > sample::SampleStreamer::windowFrames)
+        {
+            loopActive = false;
+        }
+
+        streamSlot = engine->getSampleManager()->streamer->acquireSlot(s);
+        streamLoopActive = loopActive;
+        if (!streamSlot)
+        {
+            // Out of streaming slots so just play what we have resident
+            auto lastResident = (int32_t)s->getResidentLength() - 1;
+            GD.playbackUpperBound = std::min(GD.playbackUpperBound, lastResident);
+            GD.loopUpperBound = std::min(GD.loopUpperBound, lastResident);
+            if (variantData.endLoop > lastResident)
+                loopActive = false;
+            if (GD.samplePos > lastResident)
+                GD.isFinished = true;
+        }
+    }
+
+    if (s->isCompressed() && loopActive)
+    {
+        /*
+         * A looped compressed voice reads its loop from the span the zone keeps. Until
+         * that is built a loop which can't fit the voice's own window plays through.
+         */
+        auto want = sample::DecodedSpan::loopSpanKey(*s, variantData.startLoop,
+                                                     variantData.endLoop, variantData.loopFade);
+        const auto &span = zone->compressedLoopSpans[sampleIndex];
+        if (want.sample && span && span->key == want)
+            compressedLoopSpan = span;
+
+        auto loopSpan = variantData.endLoop - variantData.startLoop + variantData.loopFade +
+                        4 * dsp::samplePadding + sample::CompressedVoiceWindow::blockFrames / 2;
+        if (want.sample && !compressedLoopSpan &&
+            loopSpan > sample::CompressedVoiceWindow::windowFrames -
+                           sample::CompressedVoiceWindow::blockFrames)
+        {
+            SCLOG_ONCE("Compressed loop has no decoded span yet; playing through it");
+            loopActive = false;
+        }
+    }
+    compressedLoopActive = loopActive;
+
+    if (loopActive)
     {
         GD.loopLowerBound = variantData.startLoop;
         GD.loopUpperBound = variantData.endLoop;
@@ -593,20 +745,279 @@ void Voice::initializeGenerator()
 
     calculateGeneratorRatio(calculateVoicePitch());
 
-    // TODO: This constant came from SC. Wonder why it is this value. There was a comment
-    // comparing with 167777216 so any speedup at all.
-    useOversampling = std::abs(GD.ratio) > 18000000 || forceOversample;
+    monoGenerator = s->channels == 1;
+    GD.interpolationType = variantData.interpolationType;
+    generatorLoopActive = loopActive;
+    fullRateBounds = {GD.loopLowerBound, GD.loopUpperBound, GD.loopFade, GD.playbackLowerBound,
+                      GD.playbackUpperBound};
+    setDecimatedLevel(pickDecimatedLevel(GD.ratio));
+    GD.ratio >>= decimatedLevel;
+
+    useOversampling = std::abs(GD.ratio) > oversampleAboveRatio || forceOversample;
     GD.blockSize = blockSize * (useOversampling ? 2 : 1);
+}
 
-    Generator = nullptr;
+int Voice::pickDecimatedLevel(int32_t ratio) const
+{
+    /*
+     * Transposing up far enough to need oversampling we would rather read a pre-filtered
+     * decimated level if the sample has one. Looped voices only do so if the loop points
+     * land exactly on the level, since moving them would retune the loop.
+     */
+    auto &s = zone->samplePointers[sampleIndex];
+    if (forceOversample || streamSlot || s->numDecimatedLevels == 0)
+        return 0;
+
+    auto r = std::abs(ratio);
+    int level{0};
+    while (level < s->numDecimatedLevels && (r >> level) > oversampleAboveRatio)
+        level++;
+
+    // Only come down a level once it is comfortably enough, so a pitch wobbling about
+    // the boundary doesn't change level every block
+    static constexpr int32_t comeDownBelowRatio{oversampleAboveRatio - oversampleAboveRatio / 16};
+    while (level < decimatedLevel && (r >> level) > comeDownBelowRatio)
+        level++;
+
+    auto mask = (1 << level) - 1;
+    while (level > 0 && generatorLoopActive &&
+           ((fullRateBounds.loopLower | fullRateBounds.loopUpper) & mask))
+        mask = (1 << --level) - 1;
+    return level;
+}
 
-    monoGenerator = s->channels == 1;
-    Generator = dsp::GetFPtrGeneratorSample(!monoGenerator, s->bitDepth == sample::Sample::BD_F32,
-                                            variantData.loopActive,
-                                            variantData.loopDirection == engine::Zone::FORWARD_ONLY,
-                                            variantData.loopMode == engine::Zone::LOOP_WHILE_GATED);
+void Voice::setDecimatedLevel(int level)
+{
+    auto &s = zone->samplePointers[sampleIndex];
+    auto &variantData = zone->variantData.variants[sampleIndex];
 
-    GD.interpolationType = variantData.interpolationType;
+    // Carry the position, sub sample part and all, and the ramp's ratio over to the level
+    auto shift = decimatedLevel - level;
+    auto pos = ((int64_t)GD.samplePos << 24) + GD.sampleSubPos;
+    pos = shift >= 0 ? pos * (1 << shift) : pos >> -shift;
+    GD.samplePos = (int32_t)(pos >> 24);
+    GD.sampleSubPos = (int32_t)(pos & 0xFFFFFF);
+    previousRatio = shift >= 0 ? previousRatio * (1 << shift) : previousRatio >> -shift;
+    decimatedLevel = level;
+
+    GD.loopLowerBound = fullRateBounds.loopLower >> level;
+    GD.loopUpperBound = fullRateBounds.loopUpper >> level;
+    GD.loopFade = fullRateBounds.loopFade >> level;
+    GD.playbackLowerBound = fullRateBounds.playbackLower >> level;
+    GD.playbackUpperBound = fullRateBounds.playbackUpper >> level;
+
+    if (level > 0)
+    {
+        GDIO.sampleDataL = s->getDecimatedSamplePtr(level - 1, 0);
+        GDIO.sampleDataR = s->getDecimatedSamplePtr(level - 1, 1);
+        GDIO.waveSize = s->decimatedLevels[level - 1].length;
+    }
+    else
+    {
+        if (s->bitDepth == sample::Sample::BD_I16)
+        {
+            GDIO.sampleDataL = s->GetSamplePtrI16(0);
+            GDIO.sampleDataR = s->GetSamplePtrI16(1);
+        }
+        else if (s->bitDepth == sample::Sample::BD_F32)
+        {
+            GDIO.sampleDataL = s->GetSamplePtrF32(0);
+            GDIO.sampleDataR = s->GetSamplePtrF32(1);
+        }
+        else if (s->bitDepth == sample::Sample::BD_I24)
+        {
+            GDIO.sampleDataL = s->GetSamplePtrI24(0);
+            GDIO.sampleDataR = s->GetSamplePtrI24(1);
+        }
+        else if (s->bitDepth == sample::Sample::BD_I8)
+        {
+            GDIO.sampleDataL = s->GetSamplePtrI8(0);
+            GDIO.sampleDataR = s->GetSamplePtrI8(1);
+        }
+        else
+        {
+            assert(false);
+        }
+        GDIO.waveSize = s->sample_length;
+    }
+
+    // Decimated levels are fully resident, so only voices reading the sample itself decode
+    if (s->isCompressed() && level == 0)
+    {
+        if (!compressedWindow.isAttached())
+            attachCompressedWindow();
+    }
+    else
+    {
+        releaseCompressedWindow();
+    }
+
+    Generator = dsp::GetFPtrGeneratorSample(
+        !monoGenerator, level > 0 ? dsp::SDF_F32 : s->getSampleDataFormat(),
+        generatorLoopActive, variantData.loopDirection == engine::Zone::FORWARD_ONLY,
+        variantData.loopMode == engine::Zone::LOOP_WHILE_GATED, GD.interpolationType,
+        generatorLoopActive && GD.loopFade > 0);
+}
+
+void Voice::runStreamingGenerator()
+{
+    int64_t base{0};
+    void *dataL{nullptr}, *dataR{nullptr};
+    auto &streamer = engine->getSampleManager()->streamer;
+
+    // The window has to cover the faster end of a pitch ramp
+    auto ratio = GD.ratio;
+    if (audioRatePitch && std::abs(previousRatio) > std::abs(ratio))
+        GD.ratio = previousRatio;
+    auto prepared = streamer->prepareBlock(*streamSlot, GD, streamLoopActive, base, dataL, dataR);
+    GD.ratio = ratio;
+
+    if (!prepared)
+    {
+        // Nothing resident covers this block yet. Hold our position and play silence
+        // rather than read outside the data we have.
+        memset(output, 0, sizeof(output));
+        engine->sharedUIMemoryState.streamingUnderruns++;
+        return;
+    }
+
+    runGeneratorAt(base, dataL, dataR);
+}
+
+void Voice::runCompressedGenerator()
+{
+    auto &s = zone->samplePointers[sampleIndex];
+
+    // As with streaming, cover the faster end of a pitch ramp
+    auto ratio = GD.ratio;
+    if (audioRatePitch && std::abs(previousRatio) > std::abs(ratio))
+        GD.ratio = previousRatio;
+    int64_t lo, hi;
+    sample::SampleStreamer::blockFrameRange(GD, compressedLoopActive, s->sample_length, lo, hi);
+    bool forward = GD.direction * (GD.ratio < 0 ? -1 : 1) >= 0;
+    GD.ratio = ratio;
+
+    if (hi <= (int64_t)s->getResidentLength())
+    {
+        if (s->bitDepth == sample::Sample::BD_F32)
+            runGeneratorAt(0, s->GetSamplePtrF32(0), s->GetSamplePtrF32(1));
+        else
+            runGeneratorAt(0, s->GetSamplePtrI16(0), s->GetSamplePtrI16(1));
+    }
+    else if (compressedLoopSpan && compressedLoopSpan->covers(lo, hi))
+    {
+        runGeneratorAt(compressedLoopSpan->key.start, compressedLoopSpan->channelData(0),
+                       compressedLoopSpan->channelData(1));
+    }
+    else if (compressedWindow.prepare(lo, hi, forward))
+    {
+        runGeneratorAt(compressedWindow.start(), compressedWindow.channelData(0),
+                       compressedWindow.channelData(1));
+    }
+    else
+    {
+        // Only a block reading further than the whole window at once lands here
+        memset(output, 0, sizeof(output));
+    }
+}
+
+void Voice::runGeneratorAt(int64_t base, void *dataL, void *dataR)
+{
+    // The generator works in absolute sample positions so rebase it onto the data
+    auto b = (int32_t)base;
+    GDIO.sampleDataL = dataL;
+    GDIO.sampleDataR = dataR;
+    GD.samplePos -= b;
+    GD.playbackLowerBound -= b;
+    GD.playbackUpperBound -= b;
+    GD.loopLowerBound -= b;
+    GD.loopUpperBound -= b;
+    GDIO.waveSize -= b;
+
+    runGenerator();
+
+    GD.samplePos += b;
+    GD.playbackLowerBound += b;
+    GD.playbackUpperBound += b;
+    GD.loopLowerBound += b;
+    GD.loopUpperBound += b;
+    GDIO.waveSize += b;
+}
+
+void Voice::runGenerator()
+{
+    auto ratio = GD.ratio;
+    if (!audioRatePitch || previousRatio == 0 || previousRatio == ratio)
+    {
+        Generator(&GD, &GDIO);
+        previousRatio = ratio;
+        return;
+    }
+
+    static_assert(pitchLaneSubBlocks == 4, "The ramp below is one SSE register wide");
+    const auto ramp = _mm_setr_ps(0.25f, 0.5f, 0.75f, 1.f);
+    auto delta = _mm_set1_ps((float)((int64_t)ratio - previousRatio));
+    int32_t ratios alignas(16)[pitchLaneSubBlocks];
+    _mm_store_si128((__m128i *)ratios, _mm_add_epi32(_mm_set1_epi32(previousRatio),
+                                                     _mm_cvtps_epi32(_mm_mul_ps(delta, ramp))));
+    ratios[pitchLaneSubBlocks - 1] = ratio;
+
+    auto blockLength = GD.blockSize;
+    auto *outL = GDIO.outputL;
+    auto *outR = GDIO.outputR;
+    auto sub = blockLength / pitchLaneSubBlocks;
+
+    GD.blockSize = sub;
+    for (int k = 0; k < pitchLaneSubBlocks; ++k)
+    {
+        GD.ratio = ratios[k];
+        GDIO.outputL = outL + k * sub;
+        GDIO.outputR = outR ? outR + k * sub : nullptr;
+        Generator(&GD, &GDIO);
+    }
+    GD.blockSize = blockLength;
+    GDIO.outputL = outL;
+    GDIO.outputR = outR;
+    GD.ratio = ratio;
+    previousRatio = ratio;
+}
+
+void Voice::releaseStreamSlot()
+{
+    if (streamSlot)
+    {
+        engine->getSampleManager()->streamer->releaseSlot(streamSlot);
+        streamSlot = nullptr;
+    }
+}
+
+void Voice::attachCompressedWindow()
+{
+    auto &s = zone->samplePointers[sampleIndex];
+    auto *block = (uint8_t *)engine->getMemoryPool()->checkoutBlock(
+        sample::CompressedVoiceWindow::poolBlockBytes);
+    compressedWindow.attach(*s, block);
+
+    if (compressedLoopActive && !compressedLoopSpan)
+    {
+        auto &variantData = zone->variantData.variants[sampleIndex];
+        auto want = sample::DecodedSpan::loopSpanKey(*s, variantData.startLoop,
+                                                     variantData.endLoop, variantData.loopFade);
+        const auto &span = zone->compressedLoopSpans[sampleIndex];
+        if (want.sample && span && span->key == want)
+            compressedLoopSpan = span;
+    }
+}
+
+void Voice::releaseCompressedWindow()
+{
+    if (compressedWindow.isAttached())
+    {
+        engine->getMemoryPool()->returnBlock(compressedWindow.getMemory(),
+                                             sample::CompressedVoiceWindow::poolBlockBytes);
+        compressedWindow.detach();
+    }
+    compressedLoopSpan.reset();
 }
 
 float Voice::calculateVoicePitch()
@@ -689,11 +1100,18 @@ void Voice::initializeProcessors()
         if ((processorIsActive[i] && processorType[i] != dsp::processor::proct_none) ||
             (processorType[i] == dsp::processor::proct_none && !processorIsActive[i]))
         {
-            processors[i] = dsp::processor::spawnProcessorInPlace(
-                processorType[i], zone->getEngine()->getMemoryPool().get(),
-                processorPlacementStorage[i], dsp::processor::processorMemoryBufferSize,
-                zone->processorStorage[i], endpoints->processorTarget[i].fp, processorIntParams[i],
-                forceOversample, false);
+            auto *mp = zone->getEngine()->getMemoryPool().get();
+            processors[i] = zone->warmProcessors.acquire(
+                i, mp, &zone->getEngine()->warmProcessorBudget, zone->processorStorage[i],
+                endpoints->processorTarget[i].fp, processorIntParams[i], forceOversample);
+            if (!processors[i])
+            {
+                processors[i] = dsp::processor::spawnProcessorInPlace(
+                    processorType[i], mp, processorPlacementStorage[i],
+                    dsp::processor::processorMemoryBufferSize, zone->processorStorage[i],
+                    endpoints->processorTarget[i].fp, processorIntParams[i], forceOversample,
+                    false);
+            }
         }
         else
         {
@@ -62,6 +62,60 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
     dsp::GeneratorFPtr Generator;
     bool monoGenerator{false};
 
+    // Disk streaming. If our sample is streamed we hold a streamer slot while playing
+    sample::SampleStreamer::Slot *streamSlot{nullptr};
+    bool streamLoopActive{false};
+    void runStreamingGenerator();
+    void releaseStreamSlot();
+
+    /*
+     * Compressed samples. A voice reads the resident head, then its zone's decoded loop
+     * span if there is one, then decodes into its own window from the memory pool.
+     */
+    sample::CompressedVoiceWindow compressedWindow;
+    std::shared_ptr<sample::DecodedSpan> compressedLoopSpan;
+    bool compressedLoopActive{false};
+    void runCompressedGenerator();
+    void attachCompressedWindow();
+    void releaseCompressedWindow();
+
+    // Run the generator over data whose first frame is sample frame base
+    void runGeneratorAt(int64_t base, void *dataL, void *dataR);
+
+    /*
+     * Audio rate pitch. The matrix runs once a block so modulated pitch steps the
+     * generator ratio once a block. With the lane on, a block whose ratio moved is
+     * rendered in pitchLaneSubBlocks pieces ramping from the previous block's ratio
+     * instead, so per 4 samples at base rate.
+     */
+    static constexpr int pitchLaneSubBlocks{4};
+    bool audioRatePitch{false};
+    int32_t previousRatio{0}; // 0 until the first block has run
+    void runGenerator();
+
+    /*
+     * Sample accurate starts. A voice started by an event part way into the block
+     * renders whole blocks as usual and then delays its output by startDelay base
+     * rate samples, carrying the overhang into the next block in startDelayLine.
+     * When the voice ends it plays one more block (startDelayTail) to emit that
+     * overhang.
+     */
+    int16_t startDelay{0};
+    bool startDelayTail{false};
+    float startDelayLine alignas(16)[2][blockSize << 1];
+    template <bool OS> void applyStartDelay();
+    void holdForStartDelayTail()
+    {
+        if (!isVoicePlaying && startDelay)
+        {
+            isVoicePlaying = true;
+            startDelayTail = true;
+        }
+    }
+
+    // Set when the engine RenderPool has already run process for this block
+    bool renderedAhead{false}, renderedAheadResult{false};
+
     sst::filters::HalfRate::HalfRateFilter halfRate;
 
     int16_t channel{0};
@@ -140,6 +194,7 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
     bool processorConsumesMono[engine::processorCount]{false, false, false, false};
 
     void initializeProcessors();
+    void releaseProcessors();
 
     using lipol = sst::basic_blocks::dsp::lipol_sse<blockSize, false>;
     using lipolOS = sst::basic_blocks::dsp::lipol_sse<blockSize << 1, false>;
@@ -160,6 +215,25 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
      */
     bool useOversampling{false};
 
+    // TODO: This constant came from SC. Wonder why it is this value. There was a comment
+    // comparing with 167777216 so any speedup at all.
+    static constexpr int32_t oversampleAboveRatio{18000000};
+
+    /*
+     * Decimated playback. If > 0 the generator reads the sample's
+     * decimatedLevels[decimatedLevel - 1] and GD positions and ratio are scaled down by
+     * 2^decimatedLevel. The level follows the voice's pitch block by block, so we keep
+     * the full rate bounds and the generator's loop setting to rebuild GD from.
+     */
+    int decimatedLevel{0};
+    struct FullRateBounds
+    {
+        int32_t loopLower{0}, loopUpper{1}, loopFade{0}, playbackLower{0}, playbackUpper{1};
+    } fullRateBounds;
+    bool generatorLoopActive{false};
+    int pickDecimatedLevel(int32_t ratio) const;
+    void setDecimatedLevel(int level);
+
     /*
      * Voice Playback State Model.
      */
@@ -170,6 +244,18 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
     bool isVoicePlaying{false};
     bool isVoiceAssigned{false};
 
+    /*
+     * Silence detection. While the generator runs we retire a voice only once its AEG is
+     * releasing below silenceThreshold. After the generator has finished we watch the
+     * output instead, and once that has stayed below silenceThreshold for longer than
+     * its processors' tails we retire it rather than render inaudible audio until the
+     * AEG completes. A processor with an infinite tail keeps the voice alive as before.
+     */
+    static constexpr float silenceThreshold{1e-5f}; // -100dB
+    static constexpr float silenceHoldSeconds{0.02f};
+    int32_t silentSamples{0}; // base rate
+    template <bool OS> bool hasGoneSilent();
+
     void attack()
     {
         isGated = true;
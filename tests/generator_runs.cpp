@@ -0,0 +1,239 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "catch2/catch2.hpp"
+#include "dsp/generator.h"
+#include "dsp/data_tables.h"
+#include "dsp/sinc_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace scxt;
+using dsp::InterpolationTypes;
+using dsp::SampleDataFormat;
+
+namespace
+{
+/*
+ * A two tone test sample in any of the generator's formats, padded either side like
+ * the sample data a voice reads.
+ */
+struct TestSample
+{
+    static constexpr int32_t length{2000};
+    static constexpr int32_t padding{64};
+
+    std::vector<uint8_t> bytes[2];
+    void *data[2]{nullptr, nullptr};
+
+    TestSample(SampleDataFormat format, int channels)
+    {
+        auto elementSize = format == dsp::SDF_F32   ? sizeof(float)
+                           : format == dsp::SDF_I24 ? sizeof(dsp::PackedI24)
+                           : format == dsp::SDF_I8  ? sizeof(int8_t)
+                                                    : sizeof(int16_t);
+        for (int c = 0; c < channels; ++c)
+        {
+            bytes[c].assign((length + 2 * padding) * elementSize, 0);
+            data[c] = bytes[c].data() + padding * elementSize;
+            for (int32_t i = 0; i < length; ++i)
+            {
+                auto v = 0.4 * std::sin(2.0 * M_PI * 0.013 * i + c) +
+                         0.4 * std::sin(2.0 * M_PI * 0.041 * i);
+                switch (format)
+                {
+                case dsp::SDF_F32:
+                    ((float *)data[c])[i] = (float)v;
+                    break;
+                case dsp::SDF_I16:
+                    ((int16_t *)data[c])[i] = (int16_t)std::lrint(v * 32767);
+                    break;
+                case dsp::SDF_I24:
+                {
+                    auto q = (int32_t)std::lrint(v * 8388607);
+                    auto &p = ((dsp::PackedI24 *)data[c])[i];
+                    p.b[0] = (uint8_t)(q & 0xFF);
+                    p.b[1] = (uint8_t)((q >> 8) & 0xFF);
+                    p.b[2] = (uint8_t)((q >> 16) & 0xFF);
+                }
+                break;
+                case dsp::SDF_I8:
+                    ((int8_t *)data[c])[i] = (int8_t)std::lrint(v * 127);
+                    break;
+                }
+            }
+        }
+    }
+};
+
+struct LoopSetup
+{
+    const char *name;
+    bool active, forward, whileGated;
+    int32_t fade;
+};
+
+struct Render
+{
+    std::vector<float> out[2];
+    std::vector<int32_t> positions, subPositions, directions, finished;
+};
+
+Render render(const TestSample &s, SampleDataFormat format, bool stereo, InterpolationTypes it,
+              const LoopSetup &loop, bool reverse, int32_t ratio, bool perSample)
+{
+    static constexpr int blocks{300};
+    static constexpr int releaseAtBlock{150};
+
+    dsp::GeneratorState GD;
+    dsp::GeneratorIO GDIO;
+    float output alignas(16)[2][blockSize];
+
+    GDIO.outputL = output[0];
+    GDIO.outputR = output[1];
+    GDIO.sampleDataL = s.data[0];
+    GDIO.sampleDataR = s.data[1];
+    GDIO.waveSize = TestSample::length;
+
+    GD.samplePos = 0;
+    GD.sampleSubPos = 0;
+    GD.playbackLowerBound = 0;
+    GD.playbackUpperBound = TestSample::length - 1;
+    GD.loopLowerBound = loop.active ? 500 : 0;
+    GD.loopUpperBound = loop.active ? 1500 : TestSample::length - 1;
+    GD.loopFade = loop.fade;
+    GD.direction = 1;
+    GD.isFinished = false;
+    if (reverse)
+    {
+        GD.samplePos = GD.playbackUpperBound;
+        GD.direction = -1;
+    }
+    GD.directionAtOutset = GD.direction;
+    GD.ratio = ratio;
+    GD.blockSize = blockSize;
+    GD.interpolationType = it;
+    GD.loopInvertedBounds = 1.f / std::max(1, GD.loopUpperBound - GD.loopLowerBound);
+    GD.playbackInvertedBounds =
+        1.f / std::max(1, GD.playbackUpperBound - GD.playbackLowerBound);
+    auto generator =
+        perSample ? dsp::GetFPtrGeneratorSamplePerSample(stereo, format, loop.active, loop.forward,
+                                                         loop.whileGated, it, loop.fade > 0)
+                  : dsp::GetFPtrGeneratorSample(stereo, format, loop.active, loop.forward,
+                                                loop.whileGated, it, loop.fade > 0);
+
+    Render res;
+    for (int b = 0; b < blocks; ++b)
+    {
+        GD.gated = b < releaseAtBlock;
+        generator(&GD, &GDIO);
+        for (int c = 0; c < (stereo ? 2 : 1); ++c)
+            res.out[c].insert(res.out[c].end(), output[c], output[c] + blockSize);
+        res.positions.push_back(GD.samplePos);
+        res.subPositions.push_back(GD.sampleSubPos);
+        res.directions.push_back(GD.direction);
+        res.finished.push_back(GD.isFinished);
+    }
+    return res;
+}
+
+// Runs read the same taps as the per sample kernels, so only the order of the sums can differ
+float tolerance(InterpolationTypes it)
+{
+    switch (it)
+    {
+    case InterpolationTypes::Sinc:
+    case InterpolationTypes::Hermite:
+    case InterpolationTypes::Polyphase:
+    case InterpolationTypes::PolyphaseLong:
+        return 1e-5f;
+    default:
+        return 1e-6f;
+    }
+}
+} // namespace
+
+TEST_CASE("Generator Runs Match The Per Sample Path")
+{
+    dsp::sincTable.init();
+    dsp::sincKernels.init();
+
+    const LoopSetup loops[] = {{"no loop", false, true, false, 0},
+                               {"forward", true, true, false, 0},
+                               {"forward fade", true, true, false, 120},
+                               {"ping pong", true, false, false, 0},
+                               {"forward while gated", true, true, true, 0},
+                               {"ping pong while gated", true, false, true, 0}};
+    const SampleDataFormat formats[] = {dsp::SDF_F32, dsp::SDF_I16, dsp::SDF_I24, dsp::SDF_I8};
+    const InterpolationTypes its[] = {InterpolationTypes::Sinc, InterpolationTypes::Linear,
+                                      InterpolationTypes::ZeroOrderHold,
+                                      InterpolationTypes::Hermite,
+                                      InterpolationTypes::Polyphase,
+                                      InterpolationTypes::PolyphaseLong};
+    const int32_t ratios[] = {(int32_t)(0.73 * (1 << 24)), 1 << 24, (int32_t)(1.9 * (1 << 24))};
+
+    for (auto format : formats)
+    {
+        for (auto stereo : {false, true})
+        {
+            TestSample s(format, stereo ? 2 : 1);
+            for (auto it : its)
+            {
+                for (const auto &loop : loops)
+                {
+                    for (auto reverse : {false, true})
+                    {
+                        for (auto ratio : ratios)
+                        {
+                            INFO("format " << (int)format << " stereo " << stereo << " "
+                                           << dsp::toStringInterpolationTypes(it) << " "
+                                           << loop.name << " reverse " << reverse << " ratio "
+                                           << ratio);
+                            auto runs = render(s, format, stereo, it, loop, reverse, ratio, false);
+                            auto each = render(s, format, stereo, it, loop, reverse, ratio, true);
+
+                            REQUIRE(runs.positions == each.positions);
+                            REQUIRE(runs.subPositions == each.subPositions);
+                            REQUIRE(runs.directions == each.directions);
+                            REQUIRE(runs.finished == each.finished);
+
+                            float maxDiff{0.f};
+                            for (int c = 0; c < (stereo ? 2 : 1); ++c)
+                                for (size_t i = 0; i < runs.out[c].size(); ++i)
+                                    maxDiff = std::max(maxDiff,
+                                                       std::fabs(runs.out[c][i] - each.out[c][i]));
+                            REQUIRE(maxDiff <= tolerance(it));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
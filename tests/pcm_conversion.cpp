@@ -0,0 +1,148 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "catch2/catch2.hpp"
+#include "sample/pcm_conversion.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace scxt;
+namespace pcm = scxt::sample::pcm;
+
+namespace
+{
+/*
+ * Plain one sample at a time references. The converters' vector loops, scalar tails and
+ * threaded splits all have to produce exactly these bits.
+ */
+int16_t refI16(const uint8_t *c, bool be)
+{
+    return be ? (int16_t)((c[0] << 8) | c[1]) : (int16_t)((c[1] << 8) | c[0]);
+}
+
+int32_t refI24(const uint8_t *c, bool be)
+{
+    int value = be ? (c[0] << 16) | (c[1] << 8) | c[2] : (c[2] << 16) | (c[1] << 8) | c[0];
+    return value - ((value & 0x800000) << 1);
+}
+
+float refI24ToF32(const uint8_t *c, bool be) { return 0.00000011920928955078f * refI24(c, be); }
+
+dsp::PackedI24 refI24ToPacked(const uint8_t *c, bool be)
+{
+    return be ? dsp::PackedI24{{c[2], c[1], c[0]}} : dsp::PackedI24{{c[0], c[1], c[2]}};
+}
+
+float refI32ToF32(const uint8_t *c, bool be)
+{
+    auto x = be ? (int32_t)(((uint32_t)c[0] << 24) | (c[1] << 16) | (c[2] << 8) | c[3])
+                : (int32_t)(((uint32_t)c[3] << 24) | (c[2] << 16) | (c[1] << 8) | c[0]);
+    return 4.6566128730772E-10f * (float)x;
+}
+
+float refF32(const uint8_t *c, bool)
+{
+    float f;
+    memcpy(&f, c, sizeof(float));
+    return f;
+}
+
+template <typename T, typename Conv, typename Ref>
+void requireBitExact(Conv conv, Ref ref, bool bigEndian, size_t bytesPerSample)
+{
+    std::mt19937 gen(2718);
+    const size_t lengths[] = {0, 1, 3, 5, 6, 7, 8, 9, 13, 64, 1001, 3 << 18};
+    for (size_t channels = 1; channels <= 3; ++channels)
+    {
+        for (auto frames : lengths)
+        {
+            auto stride = channels * bytesPerSample;
+            // Pad the source so over reading vector loads would still stay in the buffer
+            std::vector<uint8_t> src(frames * stride + 32);
+            for (auto &b : src)
+                b = (uint8_t)gen();
+
+            for (size_t c = 0; c < channels; ++c)
+            {
+                INFO("channels " << channels << " frames " << frames << " channel " << c);
+                auto *first = src.data() + c * bytesPerSample;
+
+                std::vector<T> expected(frames);
+                for (size_t i = 0; i < frames; ++i)
+                    expected[i] = ref(first + i * stride, bigEndian);
+
+                // A guard element after the output catches over writes
+                std::vector<T> got(frames + 1), gotSingle(frames + 1);
+                memset(got.data(), 0x5A, got.size() * sizeof(T));
+                memset(gotSingle.data(), 0x5A, gotSingle.size() * sizeof(T));
+                conv(first, stride, frames, got.data());
+                {
+                    pcm::SingleThreadedScope singleThreaded;
+                    conv(first, stride, frames, gotSingle.data());
+                }
+
+                REQUIRE(memcmp(got.data(), expected.data(), frames * sizeof(T)) == 0);
+                REQUIRE(memcmp(gotSingle.data(), expected.data(), frames * sizeof(T)) == 0);
+                T guard;
+                memset(&guard, 0x5A, sizeof(T));
+                REQUIRE(memcmp(&got[frames], &guard, sizeof(T)) == 0);
+                REQUIRE(memcmp(&gotSingle[frames], &guard, sizeof(T)) == 0);
+            }
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("PCM Conversion Matches The Scalar Path")
+{
+    SECTION("16 Bit")
+    {
+        requireBitExact<int16_t>(pcm::i16LEToI16, refI16, false, 2);
+        requireBitExact<int16_t>(pcm::i16BEToI16, refI16, true, 2);
+    }
+    SECTION("24 Bit To Float")
+    {
+        requireBitExact<float>(pcm::i24LEToF32, refI24ToF32, false, 3);
+        requireBitExact<float>(pcm::i24BEToF32, refI24ToF32, true, 3);
+    }
+    SECTION("24 Bit Packed")
+    {
+        requireBitExact<dsp::PackedI24>(pcm::i24LEToPacked, refI24ToPacked, false, 3);
+        requireBitExact<dsp::PackedI24>(pcm::i24BEToPacked, refI24ToPacked, true, 3);
+    }
+    SECTION("32 Bit To Float")
+    {
+        requireBitExact<float>(pcm::i32LEToF32, refI32ToF32, false, 4);
+        requireBitExact<float>(pcm::i32BEToF32, refI32ToF32, true, 4);
+    }
+    SECTION("Float")
+    {
+        requireBitExact<float>(pcm::f32LEToF32, refF32, false, 4);
+    }
+}
@@ -29,6 +29,7 @@
 #include "dsp/sample_analytics.h"
 #include <limits>
 #include <cmath>
+#include <vector>
 
 using namespace scxt;
 
@@ -113,4 +114,30 @@ TEST_CASE("Sample Analytics", "[sample]")
         REQUIRE_THAT(dsp::sample_analytics::computeRMS(sawSample),
                      Catch::WithinRel(saw_rms, tolerance));
     }
+
+    SECTION("Beyond The Resident Head")
+    {
+        // A compressed sample only keeps its head resident, and its peak is past it
+        constexpr int length{20000}, peakAt{15000};
+        std::vector<int16_t> data(length, 1000);
+        data[peakAt] = -30000;
+        const auto s = std::make_shared<sample::Sample>();
+        s->allocateI16(0, length);
+        s->load_data_i16(0, data.data(), length, sizeof(int16_t));
+        s->sample_length = length;
+        s->channels = 1;
+        s->sample_loaded = true;
+        s->streamingConfiguration.preloadFrames = 1024;
+        s->streamingConfiguration.minimumSizeInBytes = 0;
+        REQUIRE(s->compressResidentData());
+        REQUIRE(s->getResidentLength() < peakAt);
+
+        auto expectedRMS = std::sqrt(((length - 1) * 1000.0 * 1000.0 + 30000.0 * 30000.0) /
+                                     length) /
+                           32768.0;
+        REQUIRE_THAT(dsp::sample_analytics::computePeak(s),
+                     Catch::WithinRel(30000.f / 32768.f, tolerance));
+        REQUIRE_THAT(dsp::sample_analytics::computeRMS(s),
+                     Catch::WithinRel((float)expectedRMS, tolerance));
+    }
 }
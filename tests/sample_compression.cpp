@@ -0,0 +1,168 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "catch2/catch2.hpp"
+#include "sample/sample_compression.h"
+
+#include <random>
+#include <vector>
+
+using namespace scxt;
+using sample::CompressedFrames;
+
+namespace
+{
+using channel_t = std::vector<int32_t>;
+
+CompressedFrames encode(int bits, const std::vector<channel_t> &chans)
+{
+    CompressedFrames res;
+    res.channels = (uint8_t)chans.size();
+    res.bitsPerSample = (uint8_t)bits;
+    res.totalFrames = (uint32_t)chans[0].size();
+    for (size_t c = 0; c < chans.size(); ++c)
+        res.encodeChannel((int)c, [&](auto i) { return chans[c][i]; });
+    return res;
+}
+
+void requireBlocksMatch(const CompressedFrames &cf, const std::vector<channel_t> &chans)
+{
+    std::vector<int32_t> block(CompressedFrames::blockFrames);
+    for (size_t c = 0; c < chans.size(); ++c)
+    {
+        for (uint32_t b = 0; b < cf.numBlocks(); ++b)
+        {
+            cf.decodeBlock((int)c, b, block.data());
+            for (uint32_t i = 0; i < cf.blockLength(b); ++i)
+            {
+                INFO("channel " << c << " block " << b << " frame " << i);
+                REQUIRE(block[i] == chans[c][b * CompressedFrames::blockFrames + i]);
+            }
+        }
+    }
+}
+
+// decodeFrames over [from, to), with frames outside the sample reading as zero
+void requireFramesMatch(const CompressedFrames &cf, const channel_t &chan, int64_t from,
+                        int64_t to)
+{
+    INFO("frames " << from << " to " << to);
+    int64_t length = chan.size();
+    std::vector<int32_t> scratch(CompressedFrames::blockFrames);
+    if (cf.bitsPerSample > 16)
+    {
+        std::vector<float> out(to - from, -1.f);
+        cf.decodeFrames(0, from, to, true, out.data(), scratch.data());
+        auto scale = 1.f / (float)(1 << (cf.bitsPerSample - 1));
+        for (int64_t i = from; i < to; ++i)
+            REQUIRE(out[i - from] == (i >= 0 && i < length ? scale * (float)chan[i] : 0.f));
+    }
+    else
+    {
+        std::vector<int16_t> out(to - from, -1);
+        cf.decodeFrames(0, from, to, false, out.data(), scratch.data());
+        auto widen = 16 - cf.bitsPerSample;
+        for (int64_t i = from; i < to; ++i)
+        {
+            auto expected = i >= 0 && i < length ? (int16_t)(chan[i] * (1 << widen)) : 0;
+            REQUIRE(out[i - from] == expected);
+        }
+    }
+}
+
+/*
+ * A smooth signal near full scale, so a predictor wins, broken by groups of alternating
+ * full scale extremes whose residuals are the widest the format can produce.
+ */
+channel_t spikySignal(int bits, int64_t length, uint32_t seed)
+{
+    auto hi = (1 << (bits - 1)) - 1;
+    auto lo = -(1 << (bits - 1));
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int32_t> noise(lo, hi);
+
+    channel_t res(length);
+    for (int64_t i = 0; i < length; ++i)
+    {
+        auto group = i / CompressedFrames::groupFrames;
+        if (group % 7 == 3)
+            res[i] = (i & 1) ? lo : hi;
+        else if (group % 11 == 5)
+            res[i] = noise(gen);
+        else
+            res[i] = hi - (int32_t)((i % 64) * (hi / 128));
+    }
+    return res;
+}
+} // namespace
+
+TEST_CASE("Sample Compression Round Trip")
+{
+    // Whole blocks, a short final block, a short final group, and shorter than a group
+    const int64_t B = CompressedFrames::blockFrames;
+    const int64_t G = CompressedFrames::groupFrames;
+    for (auto bits : {8, 16, 24})
+    {
+        for (auto length : {3 * B, 2 * B + 5 * G, 2 * B + 37, B + 1, G + 2, (int64_t)5,
+                            (int64_t)1})
+        {
+            DYNAMIC_SECTION("Bits " << bits << " length " << length)
+            {
+                auto left = spikySignal(bits, length, 8675309 + bits);
+                auto right = left;
+                for (auto &v : right)
+                    v = -v - 1; // still in range, and the other extreme
+                auto cf = encode(bits, {left, right});
+                REQUIRE(cf.numBlocks() == (length + B - 1) / B);
+
+                requireBlocksMatch(cf, {left, right});
+
+                requireFramesMatch(cf, left, 0, length);
+                requireFramesMatch(cf, left, -20, std::min(length, (int64_t)40));
+                requireFramesMatch(cf, left, std::max((int64_t)0, length - 50), length + 20);
+                if (length > B)
+                    requireFramesMatch(cf, left, B - 17, std::min(length, B + 17));
+            }
+        }
+    }
+}
+
+TEST_CASE("Sample Compression Constant Extremes")
+{
+    // Order 0 with the widest possible values, and silence which packs to zero width
+    for (auto bits : {8, 16, 24})
+    {
+        DYNAMIC_SECTION("Bits " << bits)
+        {
+            auto length = (int64_t)CompressedFrames::blockFrames + 100;
+            channel_t lo(length, -(1 << (bits - 1))), zero(length, 0);
+            auto cf = encode(bits, {lo, zero});
+            requireBlocksMatch(cf, {lo, zero});
+            requireFramesMatch(cf, lo, 0, length);
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2024, Various authors, as described in the github
+ * transaction log.
+ *
+ * ShortcircuitXT is released under the Gnu General Public Licence
+ * V3 or later (GPL-3.0-or-later). The license is found in the file
+ * "LICENSE" in the root of this repository or at
+ * https://www.gnu.org/licenses/gpl-3.0.en.html
+ *
+ * Individual sections of code which comprises ShortcircuitXT in this
+ * repository may also be used under an MIT license. Please see the
+ * section  "Licensing" in "README.md" for details.
+ *
+ * ShortcircuitXT is inspired by, and shares code with, the
+ * commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "catch2/catch2.hpp"
+#include "engine/part.h"
+#include "engine/group.h"
+#include "engine/zone.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace scxt;
+
+namespace
+{
+using zoneList_t = std::vector<std::pair<size_t, size_t>>;
+
+zoneList_t walkZones(engine::Part &part, int16_t key, int16_t vel)
+{
+    zoneList_t res;
+    for (size_t g = 0; g < part.getGroups().size(); ++g)
+    {
+        const auto &grp = part.getGroup(g);
+        for (size_t z = 0; z < grp->getZones().size(); ++z)
+        {
+            auto &zn = grp->getZone((int)z);
+            if (zn->mapping.keyboardRange.includes(key) &&
+                zn->mapping.velocityRange.includes(vel))
+                res.emplace_back(g, z);
+        }
+    }
+    return res;
+}
+
+// What findZone does for one part: index candidates if it has them, else the walk
+zoneList_t lookupZones(engine::Part &part, int16_t key, int16_t vel)
+{
+    const engine::Part::ZoneIndexEntry *ib, *ie;
+    if (!part.zoneIndexCandidates(key, vel, ib, ie))
+        return walkZones(part, key, vel);
+
+    zoneList_t res;
+    for (auto it = ib; it != ie; ++it)
+        res.emplace_back(it->group, it->zone);
+    return res;
+}
+
+void rebuild(engine::Part &part)
+{
+    auto idx = part.buildZoneIndex();
+    REQUIRE(part.publishZoneIndex(idx));
+    REQUIRE(part.isZoneIndexCurrent());
+}
+
+void setRange(engine::Part &part, size_t g, int z, int16_t ks, int16_t ke, int16_t vs,
+              int16_t ve)
+{
+    auto &m = part.getGroup(g)->getZone(z)->mapping;
+    m.keyboardRange.keyStart = ks;
+    m.keyboardRange.keyEnd = ke;
+    m.velocityRange.velStart = vs;
+    m.velocityRange.velEnd = ve;
+    part.getGroup(g)->getZone(z)->onMappingChanged();
+}
+
+void requireMatchesWalk(engine::Part &part)
+{
+    for (int16_t k = -2; k < 131; ++k)
+    {
+        for (int16_t v = -2; v < 131; ++v)
+        {
+            INFO("key=" << k << " vel=" << v);
+            REQUIRE(lookupZones(part, k, v) == walkZones(part, k, v));
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("Zone Index Matches Zone Walk", "[engine]")
+{
+    auto part = std::make_unique<engine::Part>(0);
+    for (int g = 0; g < 3; ++g)
+    {
+        part->addGroup();
+        for (int z = 0; z < 4; ++z)
+            part->getGroup(g)->addZone(std::make_unique<engine::Zone>());
+    }
+
+    SECTION("Overlapping Ranges Keep Group Then Zone Order")
+    {
+        setRange(*part, 0, 0, 0, 127, 0, 127);
+        setRange(*part, 0, 1, 36, 72, 0, 63);
+        setRange(*part, 0, 2, 36, 72, 64, 127);
+        setRange(*part, 0, 3, 60, 60, 100, 100);
+        setRange(*part, 1, 0, 48, 84, 0, 127);
+        setRange(*part, 1, 1, 60, 60, 0, 127);
+        setRange(*part, 1, 2, 0, 0, 0, 0);
+        setRange(*part, 1, 3, 127, 127, 127, 127);
+        setRange(*part, 2, 0, 50, 70, 40, 90);
+        setRange(*part, 2, 1, 50, 70, 40, 90);
+        setRange(*part, 2, 2, 72, 36, 0, 127); // inverted, matches nothing
+        setRange(*part, 2, 3, -1, -1, 0, 127); // the unmapped default
+        rebuild(*part);
+
+        requireMatchesWalk(*part);
+        REQUIRE(lookupZones(*part, 60, 100).size() == 5);
+    }
+
+    SECTION("Ranges Outside 0-127")
+    {
+        setRange(*part, 0, 0, -10, 10, -5, 20);
+        setRange(*part, 0, 1, 120, 200, 100, 300);
+        setRange(*part, 1, 0, -100, -50, 0, 127);
+        setRange(*part, 2, 3, 0, 127, 128, 140);
+        rebuild(*part);
+
+        requireMatchesWalk(*part);
+    }
+
+    SECTION("Random Ranges")
+    {
+        std::mt19937 gen(8675309);
+        std::uniform_int_distribution<int> dist(-8, 135);
+        for (int trial = 0; trial < 4; ++trial)
+        {
+            for (int g = 0; g < 3; ++g)
+            {
+                for (int z = 0; z < 4; ++z)
+                {
+                    int16_t ks = dist(gen), ke = dist(gen), vs = dist(gen), ve = dist(gen);
+                    if (ks > ke)
+                        std::swap(ks, ke);
+                    if (vs > ve)
+                        std::swap(vs, ve);
+                    setRange(*part, g, z, ks, ke, vs, ve);
+                }
+            }
+            rebuild(*part);
+            requireMatchesWalk(*part);
+        }
+    }
+
+    SECTION("Structure And Mapping Changes Make The Index Stale")
+    {
+        setRange(*part, 0, 0, 0, 127, 0, 127);
+        rebuild(*part);
+
+        // An index built before a change must not be published after it
+        auto idx = part->buildZoneIndex();
+        setRange(*part, 0, 0, 60, 72, 0, 127);
+        REQUIRE(!part->isZoneIndexCurrent());
+        REQUIRE(!part->publishZoneIndex(idx));
+        requireMatchesWalk(*part);
+
+        rebuild(*part);
+        part->getGroup(1)->addZone(std::make_unique<engine::Zone>());
+        REQUIRE(!part->isZoneIndexCurrent());
+        setRange(*part, 1, 4, 0, 127, 0, 127);
+        rebuild(*part);
+        requireMatchesWalk(*part);
+
+        part->addGroup();
+        REQUIRE(!part->isZoneIndexCurrent());
+    }
+}